@@ -0,0 +1,219 @@
+/*allocator.cpp*/
+
+//
+//   Platform specific memory allocation for allocator.h.
+//
+//   Huge pages: on Linux an explicit MAP_HUGETLB mapping is tried first,
+// which only succeeds if huge pages have been reserved; otherwise a
+// 2MB aligned anonymous mapping is advised as a transparent huge page
+// candidate.  On Windows large pages are used if the process holds the
+// "lock pages in memory" privilege.  Elsewhere the memory is simply
+// aligned to 2MB.
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "allocator.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+
+//
+// rounds up to a multiple of alignment, a power of 2:
+//
+static inline size_t roundUp(size_t bytes, size_t alignment)
+{
+	return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+
+//
+// AlignedAlloc:
+//
+// Allocates at least bytes of memory aligned to alignment, a power of
+// 2; a zero-byte request still returns a distinct block.
+//
+void* AlignedAlloc(size_t bytes, size_t alignment)
+{
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	if (bytes == 0)
+		bytes = 1;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	void* memory = _aligned_malloc(bytes, alignment);
+#else
+	void* memory = nullptr;
+	if (posix_memalign(&memory, alignment, bytes) != 0)
+		memory = nullptr;
+#endif
+
+	if (memory == nullptr)
+		throw bad_alloc();
+
+	return memory;
+}
+
+
+void AlignedFree(void* memory)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+
+//
+// HugePageAlloc:
+//
+// Allocates bytes (rounded up to whole huge pages) of memory that is
+// backed by huge pages if the OS allows it, and by normal pages if not.
+//
+void* HugePageAlloc(size_t bytes)
+{
+	bytes = roundUp(bytes == 0 ? 1 : bytes, HUGE_PAGE_SIZE);
+
+#if defined(_WIN32)
+	SIZE_T largePage = GetLargePageMinimum();
+
+	if (largePage != 0 && bytes % largePage == 0)
+	{
+		void* memory = VirtualAlloc(nullptr, bytes,
+			MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+		if (memory != nullptr)
+			return memory;
+	}
+
+	void* memory = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+	if (memory == nullptr)
+		throw bad_alloc();
+
+	return memory;
+#elif defined(__linux__)
+#if defined(MAP_HUGETLB)
+	void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+	if (memory != MAP_FAILED)
+		return memory;
+#endif
+
+	//
+	// map an extra huge page, and trim the ends so the region starts on
+	// a huge page boundary:
+	//
+	size_t mapped = bytes + HUGE_PAGE_SIZE;
+
+	char* raw = (char*)mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (raw == (char*)MAP_FAILED)
+		throw bad_alloc();
+
+	char* aligned = (char*)roundUp((size_t)(uintptr_t)raw, HUGE_PAGE_SIZE);
+
+	if (aligned > raw)
+		munmap(raw, aligned - raw);
+	if (aligned + bytes < raw + mapped)
+		munmap(aligned + bytes, (raw + mapped) - (aligned + bytes));
+
+#if defined(MADV_HUGEPAGE)
+	madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+
+	return aligned;
+#else
+	return AlignedAlloc(bytes, HUGE_PAGE_SIZE);
+#endif
+}
+
+
+void HugePageFree(void* memory, size_t bytes)
+{
+	if (memory == nullptr)
+		return;
+
+#if defined(_WIN32)
+	(void)bytes;
+	VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+	munmap(memory, roundUp(bytes == 0 ? 1 : bytes, HUGE_PAGE_SIZE));
+#else
+	(void)bytes;
+	AlignedFree(memory);
+#endif
+}
+
+
+//
+// Arena constructors:
+//
+// Either the arena allocates (and later frees) its own region of the
+// given size, or it carves blocks out of memory the caller provides and
+// keeps alive.
+//
+Arena::Arena(size_t bytes, bool hugePages)
+{
+	this->Base = (char*)(hugePages ? HugePageAlloc(bytes) : AlignedAlloc(bytes, 64));
+	this->Size = bytes;
+	this->Used = 0;
+	this->Owned = true;
+	this->HugePages = hugePages;
+}
+
+
+Arena::Arena(void* memory, size_t bytes)
+{
+	this->Base = (char*)memory;
+	this->Size = bytes;
+	this->Used = 0;
+	this->Owned = false;
+	this->HugePages = false;
+}
+
+
+Arena::~Arena()
+{
+	if (!this->Owned)
+		return;
+
+	if (this->HugePages)
+		HugePageFree(this->Base, this->Size);
+	else
+		AlignedFree(this->Base);
+}
+
+
+//
+// Allocate:
+//
+// Returns the next bytes of the region, aligned to alignment (a power
+// of 2).  Throws bad_alloc if the region is exhausted.
+//
+void* Arena::Allocate(size_t bytes, size_t alignment)
+{
+	uintptr_t base = (uintptr_t)this->Base;
+	uintptr_t start = (uintptr_t)roundUp((size_t)(base + this->Used), alignment);
+
+	size_t offset = (size_t)(start - base);
+
+	if (offset > this->Size || bytes > this->Size - offset)
+		throw bad_alloc();
+
+	this->Used = offset + bytes;
+
+	return this->Base + offset;
+}
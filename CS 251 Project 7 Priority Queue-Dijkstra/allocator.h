@@ -0,0 +1,186 @@
+/*allocator.h*/
+
+//
+//   Allocators for the PQueue arrays.  All of them follow the standard
+// allocator interface, so PQueue (and std containers) can take any of
+// them as a template parameter:
+//
+//   AlignedAllocator   -- heap memory aligned to 64 bytes (a cache line)
+//                         by default, the PQueue default;
+//   HugePageAllocator  -- memory backed by 2MB pages where the OS allows
+//                         it, so a large heap needs far fewer TLB entries;
+//   ArenaAllocator     -- bump allocation out of an Arena, which is either
+//                         caller-provided memory or a region the arena owns
+//                         (e.g. one arena per thread).
+//
+//   Allocation failure throws std::bad_alloc, like operator new.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <memory>
+
+using namespace std;
+
+
+//
+// the platform specific parts, in allocator.cpp:
+//
+void* AlignedAlloc(size_t bytes, size_t alignment);
+void  AlignedFree(void* memory);
+
+void* HugePageAlloc(size_t bytes);
+void  HugePageFree(void* memory, size_t bytes);
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of 2");
+
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+  AlignedAllocator() { }
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) { }
+
+  T* allocate(size_t n)
+  {
+    size_t alignment = (Alignment < alignof(T)) ? alignof(T) : Alignment;
+    return (T*)AlignedAlloc(n * sizeof(T), alignment);
+  }
+
+  void deallocate(T* p, size_t) { AlignedFree(p); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+
+template <typename T>
+class HugePageAllocator
+{
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind { typedef HugePageAllocator<U> other; };
+
+  HugePageAllocator() { }
+
+  template <typename U>
+  HugePageAllocator(const HugePageAllocator<U>&) { }
+
+  T* allocate(size_t n)                { return (T*)HugePageAlloc(n * sizeof(T)); }
+  void deallocate(T* p, size_t n)      { HugePageFree(p, n * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const HugePageAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+
+//
+// Arena:
+//
+// A bump allocator over one region of memory.  Individual blocks are
+// never freed; Release() makes the whole region available again, so a
+// per-thread arena can back the queues of one query after another.
+// The arena must outlive every allocator and queue that uses it.
+//
+class Arena
+{
+private:
+  char   *Base;
+  size_t  Size;
+  size_t  Used;
+  bool    Owned;      // did the arena allocate Base?
+  bool    HugePages;  // ...with HugePageAlloc?
+
+public:
+  Arena(size_t bytes, bool hugePages = false);  // region owned by the arena:
+  Arena(void* memory, size_t bytes);            // caller-provided region:
+  ~Arena();
+
+  Arena(const Arena& other) = delete;
+  Arena& operator=(const Arena& other) = delete;
+
+  void* Allocate(size_t bytes, size_t alignment);
+  void  Release() { this->Used = 0; }
+
+  size_t BytesUsed() const { return this->Used; }
+  size_t BytesFree() const { return this->Size - this->Used; }
+};
+
+
+template <typename T, size_t Alignment = 64>
+class ArenaAllocator
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of 2");
+
+  template <typename U, size_t A> friend class ArenaAllocator;
+
+private:
+  Arena  *Region;
+
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind { typedef ArenaAllocator<U, Alignment> other; };
+
+  ArenaAllocator(Arena& region) : Region(&region) { }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U, Alignment>& other) : Region(other.Region) { }
+
+  T* allocate(size_t n)
+  {
+    size_t alignment = (Alignment < alignof(T)) ? alignof(T) : Alignment;
+    return (T*)this->Region->Allocate(n * sizeof(T), alignment);
+  }
+
+  void deallocate(T*, size_t) { }  // memory goes back with Arena::Release:
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U, Alignment>& other) const { return this->Region == other.Region; }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U, Alignment>& other) const { return this->Region != other.Region; }
+};
+
+
+//
+// AllocateArray / DeallocateArray:
+//
+// An array of n T's from any allocator, rebound to T.  The arrays are
+// not constructed, so they are meant for trivial element types that
+// are initialized by assignment.
+//
+template <typename T, typename Allocator>
+T* AllocateArray(const Allocator& allocator, size_t n)
+{
+	typename allocator_traits<Allocator>::template rebind_alloc<T> rebound(allocator);
+
+	return allocator_traits<decltype(rebound)>::allocate(rebound, n);
+}
+
+
+template <typename T, typename Allocator>
+void DeallocateArray(const Allocator& allocator, T* array, size_t n)
+{
+	typename allocator_traits<Allocator>::template rebind_alloc<T> rebound(allocator);
+
+	allocator_traits<decltype(rebound)>::deallocate(rebound, array, n);
+}
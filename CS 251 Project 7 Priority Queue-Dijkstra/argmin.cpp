@@ -0,0 +1,470 @@
+/*argmin.cpp*/
+
+//
+//   Vectorized ArgMin kernels.  Each kernel first reduces the keys to
+// their minimum with vector min instructions, then searches for the
+// first key equal to that minimum, so ties resolve exactly as they do
+// in ArgMinScalar.
+//
+//   On x86 the kernels are compiled for AVX2 and SSE4.1 via function
+// target attributes (no project-wide /arch flag is needed), and the
+// best one the CPU supports is selected the first time ArgMin is called.
+//
+
+#include <cstdint>
+
+#include "argmin.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ARGMIN_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ARGMIN_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+
+//
+// the set of kernels selected for this CPU:
+//
+struct ArgMinKernels
+{
+	int (*Double)(const double* keys, int count);
+	int (*Float)(const float* keys, int count);
+	int (*Uint32)(const uint32_t* keys, int count);
+	const char* Name;
+};
+
+
+//
+// returns the index of the first key equal to minKey, which must be
+// present in keys[from..count-1]:
+//
+template <typename Key>
+static inline int firstEqual(const Key* keys, int from, int count, Key minKey)
+{
+	for (int i = from; i < count; ++i)
+	{
+		if (keys[i] == minKey)
+			return i;
+	}
+
+	return from;  // not reached:
+}
+
+
+template <typename Key>
+static int argminScalarKernel(const Key* keys, int count)
+{
+	return ArgMinScalar(keys, count);
+}
+
+
+#if defined(ARGMIN_X86)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ARGMIN_TARGET(isa)
+#else
+#define ARGMIN_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+
+// index of lowest set bit, mask must be non-zero:
+static inline int lowestBit(unsigned mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+
+/*************************** AVX2 *******************************/
+
+ARGMIN_TARGET("avx2")
+static int argminDoubleAVX2(const double* keys, int count)
+{
+	if (count < 4)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~3;
+
+	__m256d m = _mm256_loadu_pd(keys);
+	for (int i = 4; i < vectorEnd; i += 4)
+		m = _mm256_min_pd(m, _mm256_loadu_pd(keys + i));
+
+	__m128d m2 = _mm_min_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+	m2 = _mm_min_sd(m2, _mm_unpackhi_pd(m2, m2));
+
+	double minKey = _mm_cvtsd_f64(m2);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m256d target = _mm256_set1_pd(minKey);
+	for (int i = 0; i < vectorEnd; i += 4)
+	{
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(keys + i), target, _CMP_EQ_OQ));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+ARGMIN_TARGET("avx2")
+static int argminFloatAVX2(const float* keys, int count)
+{
+	if (count < 8)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~7;
+
+	__m256 m = _mm256_loadu_ps(keys);
+	for (int i = 8; i < vectorEnd; i += 8)
+		m = _mm256_min_ps(m, _mm256_loadu_ps(keys + i));
+
+	__m128 m4 = _mm_min_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+	m4 = _mm_min_ps(m4, _mm_movehl_ps(m4, m4));
+	m4 = _mm_min_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+
+	float minKey = _mm_cvtss_f32(m4);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m256 target = _mm256_set1_ps(minKey);
+	for (int i = 0; i < vectorEnd; i += 8)
+	{
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(keys + i), target, _CMP_EQ_OQ));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+ARGMIN_TARGET("avx2")
+static int argminUint32AVX2(const uint32_t* keys, int count)
+{
+	if (count < 8)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~7;
+
+	__m256i m = _mm256_loadu_si256((const __m256i*)keys);
+	for (int i = 8; i < vectorEnd; i += 8)
+		m = _mm256_min_epu32(m, _mm256_loadu_si256((const __m256i*)(keys + i)));
+
+	__m128i m4 = _mm_min_epu32(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1));
+	m4 = _mm_min_epu32(m4, _mm_shuffle_epi32(m4, _MM_SHUFFLE(1, 0, 3, 2)));
+	m4 = _mm_min_epu32(m4, _mm_shuffle_epi32(m4, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	uint32_t minKey = (uint32_t)_mm_cvtsi128_si32(m4);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m256i target = _mm256_set1_epi32((int)minKey);
+	for (int i = 0; i < vectorEnd; i += 8)
+	{
+		__m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(keys + i)), target);
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+/*************************** SSE4.1 *******************************/
+
+ARGMIN_TARGET("sse4.1")
+static int argminDoubleSSE41(const double* keys, int count)
+{
+	if (count < 2)
+		return 0;
+
+	int vectorEnd = count & ~1;
+
+	__m128d m = _mm_loadu_pd(keys);
+	for (int i = 2; i < vectorEnd; i += 2)
+		m = _mm_min_pd(m, _mm_loadu_pd(keys + i));
+
+	m = _mm_min_sd(m, _mm_unpackhi_pd(m, m));
+
+	double minKey = _mm_cvtsd_f64(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m128d target = _mm_set1_pd(minKey);
+	for (int i = 0; i < vectorEnd; i += 2)
+	{
+		int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(keys + i), target));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+ARGMIN_TARGET("sse4.1")
+static int argminFloatSSE41(const float* keys, int count)
+{
+	if (count < 4)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~3;
+
+	__m128 m = _mm_loadu_ps(keys);
+	for (int i = 4; i < vectorEnd; i += 4)
+		m = _mm_min_ps(m, _mm_loadu_ps(keys + i));
+
+	m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+	m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+
+	float minKey = _mm_cvtss_f32(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m128 target = _mm_set1_ps(minKey);
+	for (int i = 0; i < vectorEnd; i += 4)
+	{
+		int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(keys + i), target));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+ARGMIN_TARGET("sse4.1")
+static int argminUint32SSE41(const uint32_t* keys, int count)
+{
+	if (count < 4)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~3;
+
+	__m128i m = _mm_loadu_si128((const __m128i*)keys);
+	for (int i = 4; i < vectorEnd; i += 4)
+		m = _mm_min_epu32(m, _mm_loadu_si128((const __m128i*)(keys + i)));
+
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	uint32_t minKey = (uint32_t)_mm_cvtsi128_si32(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	__m128i target = _mm_set1_epi32((int)minKey);
+	for (int i = 0; i < vectorEnd; i += 4)
+	{
+		__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys + i)), target);
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+		if (mask != 0)
+			return i + lowestBit(mask);
+	}
+
+	return firstEqual(keys, vectorEnd, count, minKey);
+}
+
+
+//
+// CPU feature detection; AVX2 also requires the OS to save the YMM
+// registers, which __builtin_cpu_supports checks for us:
+//
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+
+static bool cpuHasSSE41()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+
+	__cpuid(info, 1);
+	return (info[2] & (1 << 19)) != 0;
+#else
+	return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+
+static ArgMinKernels selectKernels()
+{
+	if (cpuHasAVX2())
+		return { argminDoubleAVX2, argminFloatAVX2, argminUint32AVX2, "avx2" };
+	if (cpuHasSSE41())
+		return { argminDoubleSSE41, argminFloatSSE41, argminUint32SSE41, "sse4.1" };
+
+	return { argminScalarKernel<double>, argminScalarKernel<float>, argminScalarKernel<uint32_t>, "scalar" };
+}
+
+
+#elif defined(ARGMIN_NEON)
+
+/*************************** NEON *******************************/
+
+static int argminDoubleNEON(const double* keys, int count)
+{
+	if (count < 2)
+		return 0;
+
+	int vectorEnd = count & ~1;
+
+	float64x2_t m = vld1q_f64(keys);
+	for (int i = 2; i < vectorEnd; i += 2)
+		m = vminq_f64(m, vld1q_f64(keys + i));
+
+	double minKey = vminvq_f64(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	return firstEqual(keys, 0, count, minKey);
+}
+
+
+static int argminFloatNEON(const float* keys, int count)
+{
+	if (count < 4)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~3;
+
+	float32x4_t m = vld1q_f32(keys);
+	for (int i = 4; i < vectorEnd; i += 4)
+		m = vminq_f32(m, vld1q_f32(keys + i));
+
+	float minKey = vminvq_f32(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	return firstEqual(keys, 0, count, minKey);
+}
+
+
+static int argminUint32NEON(const uint32_t* keys, int count)
+{
+	if (count < 4)
+		return ArgMinScalar(keys, count);
+
+	int vectorEnd = count & ~3;
+
+	uint32x4_t m = vld1q_u32(keys);
+	for (int i = 4; i < vectorEnd; i += 4)
+		m = vminq_u32(m, vld1q_u32(keys + i));
+
+	uint32_t minKey = vminvq_u32(m);
+	for (int i = vectorEnd; i < count; ++i)
+	{
+		if (keys[i] < minKey)
+			minKey = keys[i];
+	}
+
+	return firstEqual(keys, 0, count, minKey);
+}
+
+
+static ArgMinKernels selectKernels()
+{
+	return { argminDoubleNEON, argminFloatNEON, argminUint32NEON, "neon" };
+}
+
+
+#else
+
+static ArgMinKernels selectKernels()
+{
+	return { argminScalarKernel<double>, argminScalarKernel<float>, argminScalarKernel<uint32_t>, "scalar" };
+}
+
+#endif
+
+
+//
+// the kernels are selected once, on first use:
+//
+static const ArgMinKernels& kernels()
+{
+	static const ArgMinKernels selected = selectKernels();
+
+	return selected;
+}
+
+
+int ArgMin(const double* keys, int count)
+{
+	return kernels().Double(keys, count);
+}
+
+
+int ArgMin(const float* keys, int count)
+{
+	return kernels().Float(keys, count);
+}
+
+
+int ArgMin(const uint32_t* keys, int count)
+{
+	return kernels().Uint32(keys, count);
+}
+
+
+const char* ArgMinKernel()
+{
+	return kernels().Name;
+}
@@ -0,0 +1,49 @@
+/*argmin.h*/
+
+//
+//   ArgMin returns the index of the smallest of count contiguous keys,
+// the first one on ties.  This is the inner loop of a wide heap's
+// sift-down, where all children of a node have to be compared.
+//
+//   The double, float and uint32_t overloads are vectorized: AVX2 or
+// SSE4.1 chosen at runtime on x86, NEON on ARM64, and a scalar loop
+// otherwise.  Every other key type uses the scalar loop.
+//
+
+#pragma once
+
+#include <cstdint>
+
+
+int ArgMin(const double* keys, int count);
+int ArgMin(const float* keys, int count);
+int ArgMin(const uint32_t* keys, int count);
+
+const char* ArgMinKernel();  // name of the kernel selected at runtime:
+
+
+//
+// ArgMinScalar:
+//
+// Portable compare chain, count must be at least 1.
+//
+template <typename Key>
+inline int ArgMinScalar(const Key* keys, int count)
+{
+	int minIndex = 0;
+
+	for (int i = 1; i < count; ++i)
+	{
+		if (keys[i] < keys[minIndex])
+			minIndex = i;
+	}
+
+	return minIndex;
+}
+
+
+template <typename Key>
+inline int ArgMin(const Key* keys, int count)
+{
+	return ArgMinScalar(keys, count);
+}
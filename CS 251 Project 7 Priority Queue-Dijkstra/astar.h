@@ -0,0 +1,252 @@
+/*astar.h*/
+
+//
+//   Point-to-point shortest paths over a CSRGraph, using A*: Dijkstra's
+// algorithm where the queue is ordered by g(v) + h(v), the distance
+// from the source plus a heuristic estimate of the distance left to the
+// target.  The engine tracks g itself; the queue only ever sees
+// g(v) + h(v).  With a good heuristic the search heads for the target
+// and settles far fewer vertices than Dijkstra.
+//
+//   The heuristic is a template parameter, so it inlines into the
+// relaxation loop: any type with "Distance operator()(int v) const"
+// can be used, e.g. ArrayHeuristic over precomputed estimates, or
+// EuclideanHeuristic over vertex coordinates.  It must be consistent,
+// h(u) <= weight(u, v) + h(v) for every edge, and h(target) == 0, so
+// every vertex is settled at most once with its final distance (and
+// the keys a queue sees never decrease, as RadixHeap needs).
+//
+//   The queue type has the same requirements as for Dijkstra.  Only the
+// vertices a query labels are reset before the next query.
+//
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+
+using namespace std;
+
+
+//
+// ZeroHeuristic: h(v) == 0, A* then is Dijkstra stopping at the target.
+//
+template <typename Distance>
+struct ZeroHeuristic
+{
+  Distance operator()(int) const { return Distance(0); }
+};
+
+
+//
+// ArrayHeuristic: precomputed estimates, h(v) == Estimates[v].  The
+// array must outlive the heuristic.
+//
+template <typename Distance>
+struct ArrayHeuristic
+{
+  const Distance* Estimates;
+
+  ArrayHeuristic(const Distance* estimates) : Estimates(estimates) { }
+
+  Distance operator()(int v) const { return this->Estimates[v]; }
+};
+
+
+//
+// EuclideanHeuristic: straight-line distance from v to the target,
+// times Scale, over vertex coordinates X[v], Y[v].  It is consistent if
+// every edge is at least Scale times as long as the straight line
+// between its endpoints (e.g. Scale = 1 / max speed for travel times).
+// For integer distances the estimate is rounded down, which keeps it
+// consistent.  The coordinate arrays must outlive the heuristic.
+//
+template <typename Distance>
+struct EuclideanHeuristic
+{
+  const double* X;
+  const double* Y;
+  double        TargetX, TargetY;
+  double        Scale;
+
+  EuclideanHeuristic(const double* x, const double* y, int target, double scale = 1.0)
+    : X(x), Y(y), TargetX(x[target]), TargetY(y[target]), Scale(scale) { }
+
+  Distance operator()(int v) const
+  {
+    double dx = this->X[v] - this->TargetX;
+    double dy = this->Y[v] - this->TargetY;
+    double estimate = this->Scale * sqrt(dx * dx + dy * dy);
+
+    if (numeric_limits<Distance>::is_integer)
+      return (Distance)floor(estimate);
+    else
+      return (Distance)estimate;
+  }
+};
+
+
+template <typename Queue, typename Heuristic = ZeroHeuristic<typename Queue::KeyType>>
+class AStar
+{
+public:
+  typedef typename Queue::KeyType Distance;
+
+private:
+  const CSRGraph<Distance>& Graph;
+  Queue                     PQ;
+
+  vector<Distance>  Dist;     // g: best known distance from the source
+  vector<int>       Pred;     // predecessor on that path (-1 if none)
+  vector<int>       Touched;  // vertices whose Dist was set by the current query
+
+  int   Source, Target;
+  int   NumSettled;           // # of vertices popped by the last Query
+
+public:
+  AStar(const CSRGraph<Distance>& graph);
+
+  Distance Query(int source, int target, const Heuristic& h = Heuristic());
+
+  static Distance Infinity();
+
+  Distance     DistanceBetween() const  { return this->Dist[this->Target]; }
+  bool         Reached() const          { return this->Target != -1 && this->Dist[this->Target] != Infinity(); }
+  int          Settled() const          { return this->NumSettled; }
+  vector<int>  Path() const;
+};
+
+
+//
+// Constructor:
+//
+// Prepares an engine for the given graph, which must outlive the engine
+// and have non-negative edge weights (a logic_error is thrown if not).
+//
+template <typename Queue, typename Heuristic>
+AStar<Queue, Heuristic>::AStar(const CSRGraph<Distance>& graph)
+	: Graph(graph), PQ(graph.NumVertices()),
+	  Dist(graph.NumVertices(), Infinity()), Pred(graph.NumVertices(), -1)
+{
+	if (!graph.NonNegativeWeights())
+		throw logic_error("AStar: graph has a negative edge weight");
+
+	this->Source = -1;
+	this->Target = -1;
+	this->NumSettled = 0;
+}
+
+
+//
+// Infinity:
+//
+// Distance of a vertex that has not been reached; the largest value of
+// Distance when it has no infinity (integer distances).
+//
+template <typename Queue, typename Heuristic>
+typename AStar<Queue, Heuristic>::Distance AStar<Queue, Heuristic>::Infinity()
+{
+	if (numeric_limits<Distance>::has_infinity)
+		return numeric_limits<Distance>::infinity();
+	else
+		return numeric_limits<Distance>::max();
+}
+
+
+//
+// Query:
+//
+// Computes the length of a shortest path from source to target, using
+// the heuristic h for that target, and returns it (Infinity() if target
+// is unreachable).  Afterwards Path() returns the vertices of the path.
+//
+template <typename Queue, typename Heuristic>
+typename AStar<Queue, Heuristic>::Distance AStar<Queue, Heuristic>::Query(int source, int target, const Heuristic& h)
+{
+	int N = this->Graph.NumVertices();
+
+	if (source < 0 || source >= N || target < 0 || target >= N)
+		throw logic_error("AStar::Query: invalid vertex, must be 0..N-1");
+
+	for (int v : this->Touched)
+	{
+		this->Dist[v] = Infinity();
+		this->Pred[v] = -1;
+	}
+
+	this->Touched.clear();
+	this->PQ.Reset();  // the last query stopped at its target
+
+	this->Source = source;
+	this->Target = target;
+	this->NumSettled = 0;
+
+	this->Dist[source] = Distance(0);
+	this->Touched.push_back(source);
+	this->PQ.Push(source, h(source));
+
+	//
+	// with a consistent heuristic a popped vertex is settled, so we are
+	// done when the target is popped:
+	//
+	while (!this->PQ.Empty())
+	{
+		int u = this->PQ.PopMin();
+
+		this->NumSettled++;
+
+		if (u == target)
+			break;
+
+		Distance gu = this->Dist[u];
+		int64_t  end = this->Graph.EdgesEnd(u);
+
+		for (int64_t e = this->Graph.EdgesBegin(u); e < end; ++e)
+		{
+			int      t = this->Graph.Target(e);
+			Distance nd = gu + this->Graph.Weight(e);
+
+			if (nd < this->Dist[t])
+			{
+				if (this->Dist[t] == Infinity())
+					this->Touched.push_back(t);
+
+				this->Dist[t] = nd;
+				this->Pred[t] = u;
+
+				this->PQ.Push(t, nd + h(t));
+			}
+		}
+	}
+
+	return this->Dist[target];
+}
+
+
+//
+// Path:
+//
+// The vertices of the shortest path found by the last Query, from source
+// to target; empty if the target was not reached.
+//
+template <typename Queue, typename Heuristic>
+vector<int> AStar<Queue, Heuristic>::Path() const
+{
+	vector<int> path;
+
+	if (!this->Reached())
+		return path;
+
+	for (int v = this->Target; v != -1; v = this->Pred[v])
+		path.push_back(v);
+
+	reverse(path.begin(), path.end());
+
+	return path;
+}
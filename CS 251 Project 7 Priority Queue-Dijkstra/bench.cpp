@@ -0,0 +1,1201 @@
+/*bench.cpp*/
+
+//
+//   Benchmarks for the priority queue.  A workload is a recorded
+// sequence of push / pop operations; it is generated once and then
+// replayed against every queue configuration, so each configuration
+// does exactly the same work.  The popped distances are checked after
+// the clock stops, so a fast but broken heap cannot report a result.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <set>
+#include <utility>
+#include <numeric>
+#include <array>
+
+#include "pqueue.h"
+#include "fixedpqueue.h"
+#include "lazypqueue.h"
+#include "pairingheap.h"
+#include "radixheap.h"
+#include "argmin.h"
+#include "graph.h"
+#include "graphgen.h"
+#include "dijkstra.h"
+#include "executor.h"
+#include "deltastepping.h"
+#include "paralleldijkstra.h"
+#include "vertexorder.h"
+#include "streamformat.h"
+#include "bench.h"
+
+using namespace std;
+
+
+//
+// One recorded queue operation: push (V, D), or a pop when V is -1.
+//
+struct BenchOp
+{
+	int     V;
+	double  D;
+};
+
+struct Workload
+{
+	string          Name;
+	vector<BenchOp> Ops;
+};
+
+
+//
+// Reversed: successive vertices get smaller distances, so every push
+// sifts all the way to the root (the StressTest1 pattern).
+//
+static Workload reversedWorkload(int N)
+{
+	Workload w;
+	w.Name = "reversed";
+
+	for (int v = 0; v < N; ++v)
+		w.Ops.push_back({ v, (double)(N - v) });
+	for (int i = 0; i < N; ++i)
+		w.Ops.push_back({ -1, 0.0 });
+
+	return w;
+}
+
+
+//
+// Random: N random distinct distances pushed, then popped (the
+// StressTest2 pattern).
+//
+static Workload randomWorkload(int N)
+{
+	Workload w;
+	w.Name = "random";
+
+	vector<int> distances(N);
+	for (int v = 0; v < N; ++v)
+		distances[v] = v + 1;
+
+	mt19937 gen;
+	shuffle(distances.begin(), distances.end(), gen);
+
+	for (int v = 0; v < N; ++v)
+		w.Ops.push_back({ v, (double)distances[v] });
+	for (int i = 0; i < N; ++i)
+		w.Ops.push_back({ -1, 0.0 });
+
+	return w;
+}
+
+
+//
+// Relax: Dijkstra-like mix, every vertex is pushed with a random
+// distance and then improved 4 times on average (decrease-keys),
+// interleaved with pops of the current minimum.
+//
+static Workload relaxWorkload(int N)
+{
+	Workload w;
+	w.Name = "relax";
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+	uniform_real_distribution<double> distanceDis(0.0, 1.0e6);
+
+	vector<double> current(N);
+
+	for (int v = 0; v < N; ++v)
+	{
+		current[v] = distanceDis(gen);
+		w.Ops.push_back({ v, current[v] });
+	}
+
+	for (int i = 0; i < 4 * N; ++i)
+	{
+		int v = vertexDis(gen);
+
+		current[v] = current[v] * 0.9;
+		w.Ops.push_back({ v, current[v] });
+
+		if (i % 8 == 7)
+			w.Ops.push_back({ -1, 0.0 });
+	}
+
+	// drain whatever is left (pushes of popped vertices re-insert them):
+	for (int i = 0; i < 4 * N; ++i)
+		w.Ops.push_back({ -1, 0.0 });
+
+	return w;
+}
+
+
+//
+// Dense: Dijkstra from vertex 0 over a dense random graph, where each
+// popped vertex relaxes DEGREE edges to random vertices with weights
+// 1..100.  All other vertices start queued at a large distance (like
+// Fill), so most relaxations improve a queued vertex, i.e. the mix is
+// dominated by decrease-keys.  The generator runs the search itself,
+// so that only improvements of still-queued vertices are recorded.
+//
+static Workload denseWorkload(int N)
+{
+	const int DEGREE = 32;
+
+	Workload w;
+	w.Name = "dense";
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+	uniform_int_distribution<int> weightDis(1, 100);
+
+	vector<double> current(N, 1.0e9);
+	vector<bool>   done(N, false);
+
+	current[0] = 0.0;  // the source:
+	set<pair<double, int>> model;
+
+	for (int v = 0; v < N; ++v)
+	{
+		w.Ops.push_back({ v, current[v] });
+		model.insert({ current[v], v });
+	}
+
+	while (!model.empty())
+	{
+		int u = model.begin()->second;
+		model.erase(model.begin());
+		done[u] = true;
+		w.Ops.push_back({ -1, 0.0 });
+
+		for (int e = 0; e < DEGREE; ++e)
+		{
+			int    v = vertexDis(gen);
+			double d = current[u] + weightDis(gen);
+
+			if (done[v] || d >= current[v])
+				continue;
+
+			model.erase({ current[v], v });
+			current[v] = d;
+			model.insert({ current[v], v });
+			w.Ops.push_back({ v, d });
+		}
+	}
+
+	return w;
+}
+
+
+//
+// replays the workload against a Queue (e.g. PQueue<4>), returning the
+// elapsed seconds, or -1.0 if a pop returned a vertex that was not the
+// minimum.  Pops on an empty queue are skipped, so workloads may
+// over-drain.
+//
+template <typename Queue>
+static double timeWorkload(const Workload& w, int N)
+{
+	Queue           pq(N);
+	vector<double>  queued(N, -1.0);  // distance each vertex is queued with
+	vector<double>  popped;
+
+	popped.reserve(w.Ops.size());
+
+	auto start = chrono::steady_clock::now();
+
+	for (const BenchOp& op : w.Ops)
+	{
+		if (op.V >= 0)
+		{
+			pq.Push(op.V, op.D);
+			queued[op.V] = op.D;
+		}
+		else if (!pq.Empty())
+		{
+			int v = pq.PopMin();
+			popped.push_back(queued[v]);
+		}
+	}
+
+	auto stop = chrono::steady_clock::now();
+
+	//
+	// a run of pops between two pushes must come out in ascending order:
+	//
+	size_t p = 0;
+	double lastPopped = -numeric_limits<double>::infinity();
+
+	for (const BenchOp& op : w.Ops)
+	{
+		if (op.V >= 0)
+			lastPopped = -numeric_limits<double>::infinity();
+		else if (p < popped.size())
+		{
+			if (popped[p] < lastPopped)
+				return -1.0;
+
+			lastPopped = popped[p];
+			p++;
+		}
+	}
+
+	return chrono::duration<double>(stop - start).count();
+}
+
+
+//
+// prints one "Mops/sec" cell of the results table:
+//
+static bool printRate(double seconds, size_t ops)
+{
+	if (seconds < 0.0)
+	{
+		cout << setw(10) << "FAILED";
+		return false;
+	}
+
+	cout << setw(10) << (ops / seconds) / 1.0e6;
+	return true;
+}
+
+
+//
+// BenchmarkArities:
+//
+// Times the reversed, random and relax workloads for binary, 4-ary,
+// 8-ary and 16-ary heaps, and prints millions of operations per second
+// for each combination.
+//
+int BenchmarkArities(int N)
+{
+	if (N < 1)
+		return -1;
+
+	Workload workloads[] = { reversedWorkload(N), randomWorkload(N), relaxWorkload(N) };
+
+	bool   success = true;
+	size_t ops = 0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   (child selection for arity 16+: " << ArgMinKernel() << ")" << endl;
+	cout << "   Mops/sec   " << setw(10) << "arity 2" << setw(10) << "arity 4"
+		<< setw(10) << "arity 8" << setw(10) << "arity 16" << endl;
+
+	for (const Workload& w : workloads)
+	{
+		size_t n = w.Ops.size();
+
+		cout << "   " << setw(10) << left << w.Name << right << " ";
+
+		success &= printRate(timeWorkload<PQueue<2>>(w, N), n);
+		success &= printRate(timeWorkload<PQueue<4>>(w, N), n);
+		success &= printRate(timeWorkload<PQueue<8>>(w, N), n);
+		success &= printRate(timeWorkload<PQueue<16>>(w, N), n);
+
+		cout << endl;
+
+		ops += 4 * n;
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)ops;
+}
+
+
+//
+// runs Dijkstra from every source, returning the elapsed seconds; the
+// sum of the reachable distances of each run is appended to checksums
+// so different queues can be compared:
+//
+template <typename Queue>
+static double timeDijkstra(const CSRGraph<double>& graph, const vector<int>& sources, vector<double>& checksums)
+{
+	Dijkstra<Queue> engine(graph);
+
+	double seconds = 0.0;
+
+	for (int source : sources)
+	{
+		auto start = chrono::steady_clock::now();
+
+		engine.Run(source);
+
+		auto stop = chrono::steady_clock::now();
+		seconds += chrono::duration<double>(stop - start).count();
+
+		double sum = 0.0;
+		for (int v = 0; v < graph.NumVertices(); ++v)
+		{
+			if (engine.Reached(v))
+				sum += engine.DistanceTo(v);
+		}
+
+		checksums.push_back(sum);
+	}
+
+	return seconds;
+}
+
+
+//
+// BenchmarkLazy:
+//
+// Compares the indexed PQueue against the lazy-deletion LazyPQueue in
+// Dijkstra runs over random graphs with N vertices and increasing
+// average out-degree, to show where one overtakes the other.  Prints
+// milliseconds per query for each.
+//
+int BenchmarkLazy(int N)
+{
+	if (N < 1)
+		return -1;
+
+	const int64_t MAX_EDGES = 1 << 24;  // keep the graphs in memory:
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+
+	vector<int> sources;
+	for (int i = 0; i < 4; ++i)
+		sources.push_back(vertexDis(gen));
+
+	bool    success = true;
+	int64_t relaxed = 0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   ms/query   " << setw(10) << "indexed" << setw(10) << "lazy"
+		<< setw(14) << "lazy/indexed" << endl;
+
+	for (int degree = 1; degree <= 64; degree *= 2)
+	{
+		if ((int64_t)N * degree > MAX_EDGES)
+			break;
+
+		CSRGraph<double> graph = RandomGraph<double>(N, (int64_t)N * degree, gen);
+
+		vector<double> indexedSums, lazySums;
+
+		double indexed = timeDijkstra<PQueue<>>(graph, sources, indexedSums);
+		double lazy = timeDijkstra<LazyPQueue<>>(graph, sources, lazySums);
+
+		if (indexedSums != lazySums)
+			success = false;
+
+		double n = (double)sources.size();
+
+		cout << "   degree " << setw(3) << left << degree << right << " "
+			<< setw(10) << 1000.0 * indexed / n << setw(10) << 1000.0 * lazy / n
+			<< setw(14) << lazy / indexed
+			<< (indexedSums != lazySums ? "  **distances differ" : "") << endl;
+
+		relaxed += 2 * (int64_t)sources.size() * graph.NumEdges();
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)min<int64_t>(relaxed, numeric_limits<int>::max());
+}
+
+
+//
+// BenchmarkPairing:
+//
+// Compares the binary and 4-ary PQueue against the PairingHeap, whose
+// decrease-key is O(1) amortized, on the random workload (the
+// StressTest2 pattern) and on the decrease-key heavy dense workload.
+// Prints millions of operations per second for each.
+//
+int BenchmarkPairing(int N)
+{
+	if (N < 1)
+		return -1;
+
+	Workload workloads[] = { randomWorkload(N), denseWorkload(N) };
+
+	bool   success = true;
+	size_t ops = 0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   Mops/sec   " << setw(10) << "arity 2" << setw(10) << "arity 4"
+		<< setw(10) << "pairing" << endl;
+
+	for (const Workload& w : workloads)
+	{
+		size_t n = w.Ops.size();
+
+		cout << "   " << setw(10) << left << w.Name << right << " ";
+
+		success &= printRate(timeWorkload<PQueue<2>>(w, N), n);
+		success &= printRate(timeWorkload<PQueue<4>>(w, N), n);
+		success &= printRate(timeWorkload<PairingHeap<>>(w, N), n);
+
+		cout << endl;
+
+		ops += 3 * n;
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)min<size_t>(ops, numeric_limits<int>::max());
+}
+
+
+//
+// BenchmarkExecutor:
+//
+// Runs a batch of s-t queries and a batch of single-source queries on a
+// random graph with N vertices (average out-degree 4) through the
+// QueryExecutor with 1, 2, 4, ... threads up to the # of hardware
+// threads, checking the results against the 1-thread run.  Prints
+// queries per second and the speedup over 1 thread.
+//
+int BenchmarkExecutor(int N)
+{
+	if (N < 1)
+		return -1;
+
+	const size_t PAIRS = 1024;
+	const size_t SOURCES = 32;
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+
+	CSRGraph<double> graph = RandomGraph<double>(N, (int64_t)N * 4, gen);
+
+	vector<int> sources(PAIRS), targets(PAIRS);
+	for (size_t i = 0; i < PAIRS; ++i)
+	{
+		sources[i] = vertexDis(gen);
+		targets[i] = vertexDis(gen);
+	}
+
+	int maxThreads = max(1, (int)thread::hardware_concurrency());
+
+	vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	vector<double> pairsExpected, sourcesExpected;
+	double         pairsBase = 0.0, sourcesBase = 0.0;
+	bool           success = true;
+	int64_t        queries = 0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   queries/sec   " << setw(12) << "s-t" << setw(10) << "speedup"
+		<< setw(12) << "1-to-all" << setw(10) << "speedup" << endl;
+
+	for (int threads : threadCounts)
+	{
+		QueryExecutor<PQueue<>> executor(graph, threads);
+
+		vector<double> pairs(PAIRS), all(SOURCES * (size_t)N);
+
+		auto start = chrono::steady_clock::now();
+		executor.RunPairs(sources.data(), targets.data(), PAIRS, pairs.data());
+		auto middle = chrono::steady_clock::now();
+		executor.RunSources(sources.data(), SOURCES, all.data());
+		auto stop = chrono::steady_clock::now();
+
+		double pairsSeconds = chrono::duration<double>(middle - start).count();
+		double sourcesSeconds = chrono::duration<double>(stop - middle).count();
+
+		if (threads == 1)
+		{
+			pairsExpected = pairs;
+			sourcesExpected = all;
+			pairsBase = pairsSeconds;
+			sourcesBase = sourcesSeconds;
+		}
+
+		bool same = (pairs == pairsExpected && all == sourcesExpected);
+		success &= same;
+
+		cout << "   " << setw(3) << threads << " thread" << (threads == 1 ? " " : "s") << "  "
+			<< setw(12) << PAIRS / pairsSeconds << setw(10) << pairsBase / pairsSeconds
+			<< setw(12) << SOURCES / sourcesSeconds << setw(10) << sourcesBase / sourcesSeconds
+			<< (same ? "" : "  **results differ") << endl;
+
+		queries += PAIRS + SOURCES;
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)queries;
+}
+
+
+//
+// BenchmarkDelta:
+//
+// Compares the sequential Dijkstra engine against DeltaStepping with
+// 1, 2, 4, ... threads up to the # of hardware threads, on a random
+// graph with N vertices and average out-degree 8, checking that the
+// distances agree.  Prints milliseconds per query and the speedup over
+// Dijkstra.
+//
+int BenchmarkDelta(int N)
+{
+	if (N < 1)
+		return -1;
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+
+	CSRGraph<double> graph = RandomGraph<double>(N, (int64_t)N * 8, gen);
+
+	vector<int> sources;
+	for (int i = 0; i < 4; ++i)
+		sources.push_back(vertexDis(gen));
+
+	int maxThreads = max(1, (int)thread::hardware_concurrency());
+
+	vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	vector<double> expected;
+	double         dijkstra = timeDijkstra<PQueue<>>(graph, sources, expected);
+	double         n = (double)sources.size();
+	bool           success = true;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   ms/query   " << setw(12) << "time" << setw(10) << "speedup" << endl;
+	cout << "   dijkstra   " << setw(12) << 1000.0 * dijkstra / n << setw(10) << 1.0 << endl;
+
+	for (int threads : threadCounts)
+	{
+		DeltaStepping<double> engine(graph, threads);
+
+		vector<double> sums;
+		double         seconds = 0.0;
+
+		for (int source : sources)
+		{
+			auto start = chrono::steady_clock::now();
+
+			engine.Run(source);
+
+			auto stop = chrono::steady_clock::now();
+			seconds += chrono::duration<double>(stop - start).count();
+
+			double sum = 0.0;
+			for (int v = 0; v < N; ++v)
+			{
+				if (engine.Reached(v))
+					sum += engine.DistanceTo(v);
+			}
+
+			sums.push_back(sum);
+		}
+
+		success &= (sums == expected);
+
+		cout << "   delta x" << setw(2) << left << threads << right << " "
+			<< setw(12) << 1000.0 * seconds / n << setw(10) << dijkstra / seconds
+			<< (sums != expected ? "  **distances differ" : "") << endl;
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)(sources.size() * (threadCounts.size() + 1));
+}
+
+
+//
+// a queue adapter for Dijkstra that counts what the engine asks of the
+// queue: pushes of a vertex not queued, pushes of a queued vertex with
+// a smaller distance (decrease-keys), and the largest # of vertices
+// queued at once:
+//
+template <typename Queue>
+class CountingQueue
+{
+private:
+  Queue         PQ;
+  vector<char>  Queued;
+
+public:
+  typedef typename Queue::KeyType KeyType;
+
+  int64_t  Inserts;
+  int64_t  Decreases;
+  int      Current;
+  int      Peak;
+
+  CountingQueue(int N)
+    : PQ(N), Queued(N, 0), Inserts(0), Decreases(0), Current(0), Peak(0) { }
+
+  void Reset()
+  {
+    this->PQ.Reset();
+    fill(this->Queued.begin(), this->Queued.end(), 0);
+    this->Current = 0;
+  }
+
+  void Push(int vertex, KeyType distance)
+  {
+    if (this->Queued[vertex])
+      this->Decreases++;
+    else
+    {
+      this->Inserts++;
+      this->Queued[vertex] = 1;
+      this->Peak = max(this->Peak, ++this->Current);
+    }
+
+    this->PQ.Push(vertex, distance);
+  }
+
+  void PopMin(int& vertex, KeyType& distance)
+  {
+    this->PQ.PopMin(vertex, distance);
+    this->Queued[vertex] = 0;
+    this->Current--;
+  }
+
+  bool Empty() { return this->PQ.Empty(); }
+};
+
+
+//
+// runs Dijkstra from every source like timeDijkstra, then once more
+// through a CountingQueue to count the queue operations, and prints a
+// row of the BenchmarkSSSP table.  Returns the # of vertices settled
+// by the timed runs, or -1 if the distances disagree with expected
+// (which the first queue run fills in):
+//
+template <typename Queue>
+static int64_t runSSSP(const string& name, const CSRGraph<typename Queue::KeyType>& graph,
+                       const vector<int>& sources, vector<double>& expected)
+{
+	vector<double> sums;
+	double         seconds = 0.0;
+	int64_t        settled = 0;
+
+	{
+		Dijkstra<Queue> engine(graph);
+
+		for (int source : sources)
+		{
+			auto start = chrono::steady_clock::now();
+
+			engine.Run(source);
+
+			auto stop = chrono::steady_clock::now();
+			seconds += chrono::duration<double>(stop - start).count();
+			settled += engine.Settled();
+
+			double sum = 0.0;
+			for (int v = 0; v < graph.NumVertices(); ++v)
+			{
+				if (engine.Reached(v))
+					sum += (double)engine.DistanceTo(v);
+			}
+
+			sums.push_back(sum);
+		}
+	}
+
+	Dijkstra<CountingQueue<Queue>> counted(graph);
+
+	for (int source : sources)
+		counted.Run(source);
+
+	const CountingQueue<Queue>& counts = counted.PriorityQueue();
+
+	if (expected.empty())
+		expected = sums;
+
+	bool   same = (sums == expected);
+	double n = (double)sources.size();
+
+	cout << "   " << setw(10) << left << name << right
+		<< setw(12) << settled / seconds / 1.0e6
+		<< setw(12) << counts.Inserts / n
+		<< setw(12) << counts.Decreases / n
+		<< setw(10) << counts.Peak
+		<< (same ? "" : "  **distances differ") << endl;
+
+	return same ? settled : -1;
+}
+
+
+//
+// BenchmarkSSSP:
+//
+// End-to-end Dijkstra runs over the grid, power-law, random and dense
+// graphs of graphgen.h -- about N vertices each, average out-degree 8
+// for power-law and random, and at most 1024 vertices for dense --
+// with each queue backend: binary and 4-ary PQueue, LazyPQueue,
+// RadixHeap (on the same graph with integer weights) and PairingHeap.
+// Prints millions of vertices settled per second, and per query the #
+// of inserts and decrease-keys the engine issued, plus the largest #
+// of vertices queued at once.
+//
+int BenchmarkSSSP(int N)
+{
+	if (N < 1)
+		return -1;
+
+	const int DEGREE = 8;
+	const int NUM_SOURCES = 4;
+
+	const char* names[] = { "grid", "power-law", "random", "dense" };
+
+	bool    success = true;
+	int64_t settled = 0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+
+	for (int kind = 0; kind < 4; ++kind)
+	{
+		//
+		// the same graph with double and integer weights, from the same seed:
+		//
+		int side = max(1, (int)sqrt((double)N));
+
+		auto generate = [&](auto weight)
+		{
+			typedef decltype(weight) W;
+
+			mt19937 gen(12345 + kind);
+
+			if (kind == 0)
+				return GridGraph<W>(side, side, gen);
+			else if (kind == 1)
+				return PowerLawGraph<W>(N, DEGREE, gen);
+			else if (kind == 2)
+				return RandomGraph<W>(N, (int64_t)N * DEGREE, gen);
+			else
+				return DenseGraph<W>(min(N, 1024), gen);
+		};
+
+		CSRGraph<double>   graph = generate(0.0);
+		CSRGraph<uint32_t> integerGraph = generate((uint32_t)0);
+
+		mt19937 gen;
+		uniform_int_distribution<int> vertexDis(0, graph.NumVertices() - 1);
+
+		vector<int> sources;
+		for (int i = 0; i < NUM_SOURCES; ++i)
+			sources.push_back(vertexDis(gen));
+
+		cout << "   " << names[kind] << ": " << graph.NumVertices() << " vertices, "
+			<< graph.NumEdges() << " edges" << endl;
+		cout << "   " << setw(10) << left << "queue" << right << setw(12) << "Msettled/s"
+			<< setw(12) << "inserts" << setw(12) << "decreases" << setw(10) << "peak" << endl;
+
+		vector<double> expected;
+		int64_t        results[5];
+
+		results[0] = runSSSP<PQueue<2>>("binary", graph, sources, expected);
+		results[1] = runSSSP<PQueue<4>>("4-ary", graph, sources, expected);
+		results[2] = runSSSP<LazyPQueue<>>("lazy", graph, sources, expected);
+		results[3] = runSSSP<RadixHeap<uint32_t>>("radix", integerGraph, sources, expected);
+		results[4] = runSSSP<PairingHeap<>>("pairing", graph, sources, expected);
+
+		for (int64_t r : results)
+		{
+			if (r < 0)
+				success = false;
+			else
+				settled += r;
+		}
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)min<int64_t>(settled, numeric_limits<int>::max());
+}
+
+
+//
+// BenchmarkMultiQueue:
+//
+// Compares the sequential Dijkstra engine against DeltaStepping and
+// ParallelDijkstra (on a MultiQueue) with 1, 2, 4, ... threads up to
+// the # of hardware threads, on a random graph with N vertices and
+// average out-degree 8, checking that the distances agree.  Prints
+// milliseconds per query, the speedup over Dijkstra, and for the
+// MultiQueue the # of pops processed per vertex settled by Dijkstra
+// (the work its relaxed pops repeat).
+//
+int BenchmarkMultiQueue(int N)
+{
+	if (N < 1)
+		return -1;
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+
+	CSRGraph<double> graph = RandomGraph<double>(N, (int64_t)N * 8, gen);
+
+	vector<int> sources;
+	for (int i = 0; i < 4; ++i)
+		sources.push_back(vertexDis(gen));
+
+	int maxThreads = max(1, (int)thread::hardware_concurrency());
+
+	vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	vector<double> expected;
+	double         dijkstra = timeDijkstra<PQueue<>>(graph, sources, expected);
+	double         n = (double)sources.size();
+	bool           success = true;
+
+	int64_t reached = 0;
+	{
+		Dijkstra<PQueue<>> engine(graph);
+
+		for (int source : sources)
+		{
+			engine.Run(source);
+			reached += engine.Settled();
+		}
+	}
+
+	//
+	// times engine over the sources, returning the elapsed seconds and
+	// the sums of the distances of each query in sums:
+	//
+	auto timeEngine = [&](auto& engine, vector<double>& sums, int64_t& pops)
+	{
+		double seconds = 0.0;
+
+		for (int source : sources)
+		{
+			auto start = chrono::steady_clock::now();
+
+			engine.Run(source);
+
+			auto stop = chrono::steady_clock::now();
+			seconds += chrono::duration<double>(stop - start).count();
+			pops += engine.Settled();
+
+			double sum = 0.0;
+			for (int v = 0; v < N; ++v)
+			{
+				if (engine.Reached(v))
+					sum += engine.DistanceTo(v);
+			}
+
+			sums.push_back(sum);
+		}
+
+		return seconds;
+	};
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   ms/query      " << setw(12) << "delta" << setw(10) << "speedup"
+		<< setw(12) << "multiqueue" << setw(10) << "speedup" << setw(12) << "pops/vertex" << endl;
+	cout << "   dijkstra      " << setw(12) << 1000.0 * dijkstra / n << setw(10) << 1.0 << endl;
+
+	for (int threads : threadCounts)
+	{
+		DeltaStepping<double>    delta(graph, threads);
+		ParallelDijkstra<double> multi(graph, threads);
+
+		vector<double> deltaSums, multiSums;
+		int64_t        deltaPops = 0, multiPops = 0;
+
+		double deltaSeconds = timeEngine(delta, deltaSums, deltaPops);
+		double multiSeconds = timeEngine(multi, multiSums, multiPops);
+
+		bool same = (deltaSums == expected && multiSums == expected);
+		success &= same;
+
+		cout << "   " << setw(3) << threads << " thread" << (threads == 1 ? " " : "s") << "   "
+			<< setw(12) << 1000.0 * deltaSeconds / n << setw(10) << dijkstra / deltaSeconds
+			<< setw(12) << 1000.0 * multiSeconds / n << setw(10) << dijkstra / multiSeconds
+			<< setw(12) << (double)multiPops / max<int64_t>(reached, 1)
+			<< (same ? "" : "  **distances differ") << endl;
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)(sources.size() * (2 * threadCounts.size() + 1));
+}
+
+
+//
+// smallPopOrder:
+//
+// A FixedPQueue used entirely at compile time: the vertices 0..7 of a
+// small queue, popped in order after a decrease-key, as the octal
+// digits of the result.  The static_assert below checks the order, and
+// that the queue really is constexpr.
+//
+static constexpr int smallPopOrder()
+{
+	FixedPQueue<8, 2, int> pq(8);
+
+	for (int v = 0; v < 8; ++v)
+		pq.Push(v, (v * 5) % 8);  // 0 5 2 7 4 1 6 3:
+
+	pq.DecreaseKey(3, -1);
+
+	int order = 0;
+
+	while (!pq.Empty())
+		order = order * 8 + pq.PopMin();
+
+	return order;
+}
+
+static_assert(smallPopOrder() == 030527416, "FixedPQueue pops out of order at compile time");
+
+
+//
+// runs Dijkstra from source over a small graph, with a queue created
+// for the query as a per-tile router would, into dist; returns the sum
+// of the distances reached as a checksum:
+//
+template <typename Queue>
+static double tileQuery(const CSRGraph<double>& graph, int source, double* dist)
+{
+	int N = graph.NumVertices();
+
+	Queue pq(N);
+
+	for (int v = 0; v < N; ++v)
+		dist[v] = numeric_limits<double>::infinity();
+
+	dist[source] = 0.0;
+	pq.Push(source, 0.0);
+
+	double sum = 0.0;
+
+	while (!pq.Empty())
+	{
+		int    u;
+		double du;
+
+		pq.PopMin(u, du);
+		sum += du;
+
+		for (int64_t e = graph.EdgesBegin(u); e < graph.EdgesEnd(u); ++e)
+		{
+			int    t = graph.Target(e);
+			double nd = du + graph.Weight(e);
+
+			if (nd < dist[t])
+			{
+				dist[t] = nd;
+				pq.Push(t, nd);
+			}
+		}
+	}
+
+	return sum;
+}
+
+
+//
+// BenchmarkFixed:
+//
+// Runs N single-source queries over 16 x 16 grid tiles (256 vertices),
+// each with its own queue, as a tile router does: PQueue, which
+// allocates its arrays per query, against FixedPQueue<256> on the
+// stack, binary and 4-ary.  Prints microseconds per query and checks
+// that every queue finds the same distances.
+//
+int BenchmarkFixed(int N)
+{
+	if (N < 1)
+		return -1;
+
+	const int TILES = 64;
+	const int SIDE = 16;
+
+	mt19937 gen;
+	uniform_int_distribution<int> tileDis(0, TILES - 1);
+	uniform_int_distribution<int> vertexDis(0, SIDE * SIDE - 1);
+
+	vector<CSRGraph<double>> tiles;
+	for (int i = 0; i < TILES; ++i)
+		tiles.push_back(GridGraph<double>(SIDE, SIDE, gen));
+
+	vector<pair<int, int>> queries(N);  // (tile, source):
+	for (int i = 0; i < N; ++i)
+		queries[i] = { tileDis(gen), vertexDis(gen) };
+
+	array<double, SIDE * SIDE> dist;
+	vector<double>             expected;
+	bool                       success = true;
+
+	auto timeQueries = [&](const string& name, auto query)
+	{
+		vector<double> sums;
+		sums.reserve(N);
+
+		auto start = chrono::steady_clock::now();
+
+		for (const pair<int, int>& q : queries)
+			sums.push_back(query(tiles[q.first], q.second, dist.data()));
+
+		auto stop = chrono::steady_clock::now();
+
+		if (expected.empty())
+			expected = sums;
+
+		bool same = (sums == expected);
+		success &= same;
+
+		cout << "   " << setw(22) << left << name << right << setw(10)
+			<< 1.0e6 * chrono::duration<double>(stop - start).count() / N
+			<< (same ? "" : "  **distances differ") << endl;
+	};
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   " << setw(22) << left << "us/query" << right << endl;
+
+	timeQueries("PQueue<2>", tileQuery<PQueue<2>>);
+	timeQueries("PQueue<4>", tileQuery<PQueue<4>>);
+	timeQueries("FixedPQueue<256, 2>", tileQuery<FixedPQueue<SIDE * SIDE, 2>>);
+	timeQueries("FixedPQueue<256, 4>", tileQuery<FixedPQueue<SIDE * SIDE, 4>>);
+
+	if (!success)
+		return -1;
+
+	return 4 * N;
+}
+
+
+//
+// BenchmarkReorder:
+//
+// Dijkstra over a square grid of about N vertices (a road-like graph),
+// with its vertices numbered in random order, as they might come from
+// an input file, and then renumbered by reverse Cuthill-McKee and by a
+// Hilbert curve through the grid positions; the row-major numbering of
+// the grid is shown for reference.  Prints the time to compute each
+// order, the mean edge span and milliseconds per query, and checks
+// that every numbering finds the same distances.
+//
+int BenchmarkReorder(int N)
+{
+	if (N < 4)
+		return -1;
+
+	const int SOURCES = 4;
+
+	int side = (int)sqrt((double)N);
+
+	mt19937 gen;
+	uniform_int_distribution<int> vertexDis(0, side * side - 1);
+
+	CSRGraph<double> grid = GridGraph<double>(side, side, gen);
+
+	vector<int> shuffled(grid.NumVertices());
+	iota(shuffled.begin(), shuffled.end(), 0);
+	shuffle(shuffled.begin(), shuffled.end(), gen);
+
+	VertexOrder      random(shuffled);
+	CSRGraph<double> input = grid.Permuted(random.NewIdArray());
+
+	vector<double> X(input.NumVertices()), Y(input.NumVertices());  // grid position of each input vertex:
+	for (int v = 0; v < grid.NumVertices(); ++v)
+	{
+		X[random.ToNew(v)] = (double)(v % side);
+		Y[random.ToNew(v)] = (double)(v / side);
+	}
+
+	vector<int> sources;  // in the input ids:
+	for (int i = 0; i < SOURCES; ++i)
+		sources.push_back(vertexDis(gen));
+
+	vector<double> expected;
+	bool           success = true;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed << std::setprecision(2);
+	cout << "   " << side << " x " << side << " grid" << endl;
+	cout << "   " << setw(12) << left << "order" << right << setw(12) << "order ms" << setw(12) << "edge span"
+		<< setw(12) << "ms/query" << endl;
+
+	//
+	// order maps the input ids to the searched graph's:
+	//
+	auto timeOrder = [&](const string& name, const CSRGraph<double>& graph, const VertexOrder& order, double orderSeconds)
+	{
+		vector<int> mapped;
+		for (int source : sources)
+			mapped.push_back(order.ToNew(source));
+
+		vector<double> sums;
+		double         seconds = timeDijkstra<PQueue<>>(graph, mapped, sums);
+
+		if (expected.empty())
+			expected = sums;
+
+		bool same = (sums == expected);  // integer weights, so the sums are exact:
+		success &= same;
+
+		cout << "   " << setw(12) << left << name << right << setw(12) << 1000.0 * orderSeconds
+			<< setw(12) << MeanEdgeSpan(graph) << setw(12) << 1000.0 * seconds / SOURCES
+			<< (same ? "" : "  **distances differ") << endl;
+	};
+
+	timeOrder("input", input, VertexOrder(), 0.0);
+	timeOrder("row-major", grid, VertexOrder(random.NewIdArray()), 0.0);
+
+	auto start = chrono::steady_clock::now();
+	VertexOrder rcm = CuthillMcKeeOrder(input);
+	auto stop = chrono::steady_clock::now();
+
+	timeOrder("rcm", input.Permuted(rcm.NewIdArray()), rcm, chrono::duration<double>(stop - start).count());
+
+	start = chrono::steady_clock::now();
+	VertexOrder hilbert = HilbertOrder(X, Y);
+	stop = chrono::steady_clock::now();
+
+	timeOrder("hilbert", input.Permuted(hilbert.NewIdArray()), hilbert, chrono::duration<double>(stop - start).count());
+
+	if (!success)
+		return -1;
+
+	return 4 * SOURCES;
+}
@@ -0,0 +1,20 @@
+/*bench.h*/
+
+//
+// Timing benchmarks for the priority queue, run from the driver's
+// "stress" command.  Each benchmark returns the # of queue operations
+// it timed, or -1 if the queue produced a wrong result.
+//
+
+#pragma once
+
+
+int BenchmarkArities(int N);
+int BenchmarkLazy(int N);
+int BenchmarkPairing(int N);
+int BenchmarkExecutor(int N);
+int BenchmarkDelta(int N);
+int BenchmarkSSSP(int N);
+int BenchmarkMultiQueue(int N);
+int BenchmarkFixed(int N);
+int BenchmarkReorder(int N);
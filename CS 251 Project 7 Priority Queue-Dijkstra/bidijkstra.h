@@ -0,0 +1,302 @@
+/*bidijkstra.h*/
+
+//
+//   Point-to-point shortest paths over a CSRGraph, using bidirectional
+// Dijkstra: a forward search from the source over the graph and a
+// backward search from the target over the reversed graph, each with
+// its own priority queue.  The side whose next vertex is closer is
+// expanded; whenever an edge reaches a vertex the other side has
+// labeled, the path through it is a candidate for the best meeting
+// distance.  The search stops as soon as the two top distances add up
+// to at least the best meeting distance, since no later meeting can be
+// shorter, so it settles roughly two balls of half the radius instead
+// of one of the full radius.
+//
+//   The queue type has the same requirements as for Dijkstra, plus a
+// non-destructive TopDistance.  Only the vertices a query labels are
+// reset before the next query, so the cost of a query is proportional
+// to the part of the graph it explores.
+//
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+
+using namespace std;
+
+
+template <typename Queue>
+class BidirectionalDijkstra
+{
+public:
+  typedef typename Queue::KeyType Distance;
+
+private:
+  //
+  // one direction of the search:
+  //
+  struct Search
+  {
+    const CSRGraph<Distance>* Graph;
+    Queue                     PQ;
+
+    vector<Distance>  Dist;     // best known distance from the source (forward) or to the target (backward)
+    vector<int>       Pred;     // previous vertex on that path, in the direction of the search
+    vector<int>       Touched;  // vertices whose Dist was set by the current query
+
+    Search(const CSRGraph<Distance>* graph, int N)
+      : Graph(graph), PQ(N), Dist(N, Infinity()), Pred(N, -1) { }
+  };
+
+  const CSRGraph<Distance>& Graph;
+  CSRGraph<Distance>        OwnedReverse;  // in-edges, unless shared by the caller
+
+  Search    Sides[2];        // [0] forward, [1] backward
+
+  Distance  Best;            // best meeting distance found so far
+  int       Meet;            // vertex where that path meets (-1 if none)
+  int       Source, Target;
+  int       NumSettled;      // # of vertices popped by the last Query, both sides
+
+  void init();
+  void clear(Search& side);
+  void settle(int s);
+
+public:
+  BidirectionalDijkstra(const CSRGraph<Distance>& graph);
+  BidirectionalDijkstra(const CSRGraph<Distance>& graph, const CSRGraph<Distance>& reversed);
+
+  Distance Query(int source, int target);
+
+  static Distance Infinity();
+
+  Distance     DistanceBetween() const  { return this->Best; }
+  bool         Reached() const          { return this->Meet != -1; }
+  int          MeetingVertex() const    { return this->Meet; }
+  int          Settled() const          { return this->NumSettled; }
+  vector<int>  Path() const;
+};
+
+
+//
+// Constructor:
+//
+// Prepares an engine for the given graph, which must outlive the engine
+// and have non-negative edge weights (a logic_error is thrown if not).
+// The reversed graph is built once, here; engines that share a graph
+// can also share its reversal (graph.Reversed()), which must then
+// outlive them too.
+//
+template <typename Queue>
+BidirectionalDijkstra<Queue>::BidirectionalDijkstra(const CSRGraph<Distance>& graph)
+	: Graph(graph), OwnedReverse(graph.Reversed()),
+	  Sides{ Search(&graph, graph.NumVertices()), Search(&this->OwnedReverse, graph.NumVertices()) }
+{
+	this->init();
+}
+
+
+template <typename Queue>
+BidirectionalDijkstra<Queue>::BidirectionalDijkstra(const CSRGraph<Distance>& graph, const CSRGraph<Distance>& reversed)
+	: Graph(graph),
+	  Sides{ Search(&graph, graph.NumVertices()), Search(&reversed, graph.NumVertices()) }
+{
+	if (reversed.NumVertices() != graph.NumVertices() || reversed.NumEdges() != graph.NumEdges())
+		throw logic_error("BidirectionalDijkstra: reversed graph does not match the graph");
+
+	this->init();
+}
+
+
+//
+// Infinity:
+//
+// Distance of a vertex that has not been reached; the largest value of
+// Distance when it has no infinity (integer distances).
+//
+template <typename Queue>
+typename BidirectionalDijkstra<Queue>::Distance BidirectionalDijkstra<Queue>::Infinity()
+{
+	if (numeric_limits<Distance>::has_infinity)
+		return numeric_limits<Distance>::infinity();
+	else
+		return numeric_limits<Distance>::max();
+}
+
+
+//
+// Query:
+//
+// Computes the length of a shortest path from source to target, and
+// returns it (Infinity() if target is unreachable).  Afterwards Path()
+// returns the vertices of that path.
+//
+template <typename Queue>
+typename BidirectionalDijkstra<Queue>::Distance BidirectionalDijkstra<Queue>::Query(int source, int target)
+{
+	int N = this->Graph.NumVertices();
+
+	if (source < 0 || source >= N || target < 0 || target >= N)
+		throw logic_error("BidirectionalDijkstra::Query: invalid vertex, must be 0..N-1");
+
+	this->clear(this->Sides[0]);
+	this->clear(this->Sides[1]);
+
+	this->Source = source;
+	this->Target = target;
+	this->NumSettled = 0;
+
+	if (source == target)
+	{
+		this->Best = Distance(0);
+		this->Meet = source;
+		return this->Best;
+	}
+
+	this->Best = Infinity();
+	this->Meet = -1;
+
+	int ends[2] = { source, target };
+
+	for (int s = 0; s < 2; ++s)
+	{
+		Search& side = this->Sides[s];
+
+		side.Dist[ends[s]] = Distance(0);
+		side.Touched.push_back(ends[s]);
+		side.PQ.Push(ends[s], Distance(0));
+	}
+
+	//
+	// if either side runs empty, it has settled everything it can reach,
+	// and every meeting was seen while relaxing its edges:
+	//
+	while (!this->Sides[0].PQ.Empty() && !this->Sides[1].PQ.Empty())
+	{
+		Distance forward = this->Sides[0].PQ.TopDistance();
+		Distance backward = this->Sides[1].PQ.TopDistance();
+
+		if (this->Best != Infinity() && !(forward + backward < this->Best))
+			break;
+
+		this->settle(forward <= backward ? 0 : 1);
+	}
+
+	return this->Best;
+}
+
+
+//
+// Path:
+//
+// The vertices of the shortest path found by the last Query, from source
+// to target; empty if the target was not reached.
+//
+template <typename Queue>
+vector<int> BidirectionalDijkstra<Queue>::Path() const
+{
+	vector<int> path;
+
+	if (this->Meet == -1)
+		return path;
+
+	for (int v = this->Meet; v != -1; v = this->Sides[0].Pred[v])
+		path.push_back(v);
+
+	reverse(path.begin(), path.end());
+
+	for (int v = this->Sides[1].Pred[this->Meet]; v != -1; v = this->Sides[1].Pred[v])
+		path.push_back(v);
+
+	return path;
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// checks the weights and sets up the state before the first query:
+//
+template <typename Queue>
+void BidirectionalDijkstra<Queue>::init()
+{
+	const CSRGraph<Distance>& graph = this->Graph;
+
+	if (!graph.NonNegativeWeights())
+		throw logic_error("BidirectionalDijkstra: graph has a negative edge weight");
+
+	this->Best = Infinity();
+	this->Meet = -1;
+	this->Source = -1;
+	this->Target = -1;
+	this->NumSettled = 0;
+}
+
+
+//
+// resets the vertices labeled by the last query, and the queue (in
+// case the last query stopped early or was interrupted):
+//
+template <typename Queue>
+void BidirectionalDijkstra<Queue>::clear(Search& side)
+{
+	for (int v : side.Touched)
+	{
+		side.Dist[v] = Infinity();
+		side.Pred[v] = -1;
+	}
+
+	side.Touched.clear();
+	side.PQ.Reset();
+}
+
+
+//
+// settles the next vertex of side s, relaxing its edges and recording
+// any better meeting with the other side:
+//
+template <typename Queue>
+void BidirectionalDijkstra<Queue>::settle(int s)
+{
+	Search&       side = this->Sides[s];
+	const Search& other = this->Sides[1 - s];
+
+	int      u;
+	Distance du;
+
+	side.PQ.PopMin(u, du);
+
+	this->NumSettled++;
+
+	const CSRGraph<Distance>& graph = *side.Graph;
+	int64_t end = graph.EdgesEnd(u);
+
+	for (int64_t e = graph.EdgesBegin(u); e < end; ++e)
+	{
+		int      t = graph.Target(e);
+		Distance nd = du + graph.Weight(e);
+
+		if (nd < side.Dist[t])
+		{
+			if (side.Dist[t] == Infinity())
+				side.Touched.push_back(t);
+
+			side.Dist[t] = nd;
+			side.Pred[t] = u;
+
+			side.PQ.Push(t, nd);
+		}
+
+		if (other.Dist[t] != Infinity() && side.Dist[t] + other.Dist[t] < this->Best)
+		{
+			this->Best = side.Dist[t] + other.Dist[t];
+			this->Meet = t;
+		}
+	}
+}
@@ -0,0 +1,392 @@
+/*deltastepping.h*/
+
+//
+//   Parallel single-source shortest paths over a CSRGraph, using
+// delta-stepping: instead of settling one vertex at a time from a
+// priority queue, vertices are kept in buckets of width Delta by
+// distance, and all vertices of the lowest non-empty bucket are
+// relaxed in parallel.  Light edges (weight <= Delta) can put vertices
+// back into the current bucket, so the bucket is repeated until it
+// stays empty; heavy edges can only reach later buckets, so they are
+// relaxed once per bucket, for every vertex the bucket settled.
+//
+//   Distances are updated with an atomic min (compare-and-swap), so any
+// worker may relax any edge.  Each worker collects the vertices it
+// improved in its own buckets; when a bucket is processed, workers
+// first take chunks of their own share and then steal chunks from the
+// others, so one worker with a large share does not hold up the rest.
+// The predecessors are derived from the final distances in a parallel
+// pass over the edges afterwards (see shortestpathtree.h).
+//
+//   It takes the same CSRGraph and has the same results interface as
+// the Dijkstra engine, so either can be chosen per query: delta-
+// stepping pays off on large graphs with many cores, Dijkstra on small
+// graphs or local queries.  The predecessors form a shortest path tree,
+// but where several shortest paths exist it may differ from the one
+// Dijkstra reports.
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+#include "threadpool.h"
+#include "shortestpathtree.h"
+
+using namespace std;
+
+
+template <typename W = double>
+class DeltaStepping
+{
+public:
+  typedef W Distance;
+
+private:
+  struct alignas(64) Worker
+  {
+    vector<vector<int>>  Buckets;   // vertices this worker improved, by bucket (cyclic)
+    vector<int>          Current;   // its share of the bucket being processed
+    vector<int>          Done;      // vertices it settled in the current bucket
+    atomic<size_t>       Cursor;    // next unclaimed entry of Current / Done
+
+    Worker() : Cursor(0) { }
+  };
+
+  static const size_t CHUNK = 64;  // entries claimed at a time:
+
+  const CSRGraph<Distance>& Graph;
+  ThreadPool                Pool;
+  vector<Worker>            Workers;
+
+  unique_ptr<atomic<Distance>[]>  Tentative;  // distances during a run
+  unique_ptr<atomic<int>[]>       Parent;     // scratch for FindPredecessors
+  unique_ptr<atomic<uint32_t>[]>  Mark;       // == Epoch if settled in the current bucket
+  uint32_t                        Epoch;
+
+  vector<Distance>  Dist;   // results of the last Run
+  vector<int>       Pred;
+
+  Distance  Delta;          // bucket width
+  size_t    NumBuckets;     // # of cyclic buckets, covers [i, i + max weight / Delta]
+  int       Source;
+  int       NumSettled;     // # of vertices settled by the last Run
+
+  size_t bucketOf(Distance d) const { return (size_t)(d / this->Delta); }
+
+  static bool atomicMin(atomic<Distance>& slot, Distance value);
+
+  template <typename Func>
+  void forEachEntry(vector<int> Worker::* list, const Func& func);
+
+  void relax(int u, Distance du, bool light, vector<vector<int>>& buckets);
+  void processBucket(size_t i);
+
+public:
+  DeltaStepping(const CSRGraph<Distance>& graph, int numThreads = 0, Distance delta = Distance(0));
+
+  void Run(int source);
+
+  static Distance Infinity();
+
+  Distance  BucketWidth() const { return this->Delta; }
+  int       Threads() const     { return this->Pool.Size(); }
+
+  const vector<Distance>& Distances() const    { return this->Dist; }
+  const vector<int>&      Predecessors() const { return this->Pred; }
+
+  Distance  DistanceTo(int v) const     { return this->Dist[v]; }
+  int       PredecessorOf(int v) const  { return this->Pred[v]; }
+  bool      Reached(int v) const        { return this->Dist[v] != Infinity(); }
+  int       Settled() const             { return this->NumSettled; }
+};
+
+
+//
+// Constructor:
+//
+// Prepares an engine for the given graph, which must outlive the engine
+// and have non-negative edge weights (a logic_error is thrown if not),
+// with numThreads workers (0 => one per hardware thread).  If delta is
+// 0 the bucket width is the maximum edge weight divided by the average
+// out-degree, which keeps the # of vertices re-relaxed within a bucket
+// small on graphs with random weights.
+//
+template <typename W>
+DeltaStepping<W>::DeltaStepping(const CSRGraph<Distance>& graph, int numThreads, Distance delta)
+	: Graph(graph), Pool(numThreads), Workers(Pool.Size()),
+	  Tentative(new atomic<Distance>[graph.NumVertices()]),
+	  Parent(new atomic<int>[graph.NumVertices()]),
+	  Mark(new atomic<uint32_t>[graph.NumVertices()]),
+	  Dist(graph.NumVertices(), Infinity()), Pred(graph.NumVertices(), -1)
+{
+	if (!graph.NonNegativeWeights())
+		throw logic_error("DeltaStepping: graph has a negative edge weight");
+
+	Distance maxWeight = Distance(0);
+
+	for (int64_t e = 0; e < graph.NumEdges(); ++e)  // sizes the buckets:
+		maxWeight = max(maxWeight, graph.Weight(e));
+
+	if (delta < Distance(0))
+		throw logic_error("DeltaStepping: bucket width must not be negative");
+
+	if (delta == Distance(0))
+	{
+		double degree = (graph.NumVertices() > 0) ? (double)graph.NumEdges() / graph.NumVertices() : 1.0;
+		delta = (Distance)(maxWeight / max(1.0, degree));
+	}
+
+	if (!(delta > Distance(0)))  // all weights 0, or rounded down to 0:
+		delta = Distance(1);
+
+	this->Delta = delta;
+	this->NumBuckets = this->bucketOf(maxWeight) + 2;
+
+	for (Worker& worker : this->Workers)
+		worker.Buckets.resize(this->NumBuckets);
+
+	for (int v = 0; v < graph.NumVertices(); ++v)
+		this->Mark[v].store(0, memory_order_relaxed);
+
+	this->Epoch = 0;
+	this->Source = -1;
+	this->NumSettled = 0;
+}
+
+
+//
+// Infinity:
+//
+// Distance of a vertex that has not been reached; the largest value of
+// Distance when it has no infinity (integer distances).
+//
+template <typename W>
+typename DeltaStepping<W>::Distance DeltaStepping<W>::Infinity()
+{
+	if (numeric_limits<Distance>::has_infinity)
+		return numeric_limits<Distance>::infinity();
+	else
+		return numeric_limits<Distance>::max();
+}
+
+
+//
+// Run:
+//
+// Computes shortest paths from source to every vertex, with the same
+// results as Dijkstra::Run: Distances()[v] is the length of a shortest
+// path to v (Infinity() if v is unreachable), and Predecessors()[v] the
+// vertex before v on such a path (-1 for the source and unreachable
+// vertices).
+//
+template <typename W>
+void DeltaStepping<W>::Run(int source)
+{
+	int N = this->Graph.NumVertices();
+
+	if (source < 0 || source >= N)
+		throw logic_error("DeltaStepping::Run: invalid source vertex, must be 0..N-1");
+
+	for (int v = 0; v < N; ++v)
+		this->Tentative[v].store(Infinity(), memory_order_relaxed);
+
+	for (Worker& worker : this->Workers)
+	{
+		for (vector<int>& bucket : worker.Buckets)
+			bucket.clear();
+	}
+
+	this->Source = source;
+	this->NumSettled = 0;
+
+	this->Tentative[source].store(Distance(0), memory_order_relaxed);
+	this->Workers[0].Buckets[0].push_back(source);
+
+	//
+	// process the lowest non-empty bucket until all are empty; the live
+	// entries are always within NumBuckets of the current bucket i:
+	//
+	size_t i = 0;
+
+	for (;;)
+	{
+		size_t k = 0;
+
+		for (; k < this->NumBuckets; ++k)
+		{
+			size_t slot = (i + k) % this->NumBuckets;
+			bool   found = false;
+
+			for (Worker& worker : this->Workers)
+				found |= !worker.Buckets[slot].empty();
+
+			if (found)
+				break;
+		}
+
+		if (k == this->NumBuckets)
+			break;
+
+		i += k;
+
+		this->processBucket(i);
+	}
+
+	for (int v = 0; v < N; ++v)
+		this->Dist[v] = this->Tentative[v].load(memory_order_relaxed);
+
+	FindPredecessors(this->Graph, source, this->Dist.data(), Infinity(), this->Parent.get(), this->Pred.data(), this->Pool);
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// lowers slot to value if value is smaller, returning true if it did:
+//
+template <typename W>
+inline bool DeltaStepping<W>::atomicMin(atomic<Distance>& slot, Distance value)
+{
+	Distance current = slot.load(memory_order_relaxed);
+
+	while (value < current)
+	{
+		if (slot.compare_exchange_weak(current, value, memory_order_relaxed))
+			return true;
+	}
+
+	return false;
+}
+
+
+//
+// calls func(v, worker) in parallel for every entry v of the list
+// (Current or Done) of every worker: each worker claims chunks of its
+// own list first, then steals chunks from the others' lists:
+//
+template <typename W>
+template <typename Func>
+void DeltaStepping<W>::forEachEntry(vector<int> Worker::* list, const Func& func)
+{
+	for (Worker& worker : this->Workers)
+		worker.Cursor.store(0, memory_order_relaxed);
+
+	int T = (int)this->Workers.size();
+
+	this->Pool.Run([&](int w)
+	{
+		for (int k = 0; k < T; ++k)
+		{
+			Worker&            victim = this->Workers[(w + k) % T];
+			const vector<int>& entries = victim.*list;
+			size_t             size = entries.size();
+
+			for (size_t begin = victim.Cursor.fetch_add(CHUNK); begin < size; begin = victim.Cursor.fetch_add(CHUNK))
+			{
+				size_t end = min(begin + CHUNK, size);
+
+				for (size_t e = begin; e < end; ++e)
+					func(entries[e], w);
+			}
+		}
+	});
+}
+
+
+//
+// relaxes the light (weight <= Delta) or heavy edges of u, at distance
+// du; improved vertices go into the given (worker's) buckets:
+//
+template <typename W>
+inline void DeltaStepping<W>::relax(int u, Distance du, bool light, vector<vector<int>>& buckets)
+{
+	int64_t end = this->Graph.EdgesEnd(u);
+
+	for (int64_t e = this->Graph.EdgesBegin(u); e < end; ++e)
+	{
+		Distance w = this->Graph.Weight(e);
+
+		if ((w <= this->Delta) != light)
+			continue;
+
+		int      t = this->Graph.Target(e);
+		Distance nd = du + w;
+
+		if (atomicMin(this->Tentative[t], nd))
+			buckets[this->bucketOf(nd) % this->NumBuckets].push_back(t);
+	}
+}
+
+
+//
+// settles bucket i: relax the light edges of its vertices until no more
+// vertices fall into it, then the heavy edges of all vertices it
+// settled.  Entries whose distance has since moved to a lower bucket
+// are stale and skipped:
+//
+template <typename W>
+void DeltaStepping<W>::processBucket(size_t i)
+{
+	size_t slot = i % this->NumBuckets;
+
+	this->Epoch++;
+
+	if (this->Epoch == 0)  // wrapped around, old marks could look current:
+	{
+		for (int v = 0; v < this->Graph.NumVertices(); ++v)
+			this->Mark[v].store(0, memory_order_relaxed);
+
+		this->Epoch = 1;
+	}
+
+	uint32_t epoch = this->Epoch;
+
+	for (Worker& worker : this->Workers)
+		worker.Done.clear();
+
+	for (;;)
+	{
+		bool empty = true;
+
+		for (Worker& worker : this->Workers)
+		{
+			worker.Current.clear();
+			worker.Current.swap(worker.Buckets[slot]);
+			empty &= worker.Current.empty();
+		}
+
+		if (empty)
+			break;
+
+		this->forEachEntry(&Worker::Current, [&](int u, int w)
+		{
+			Distance du = this->Tentative[u].load(memory_order_relaxed);
+
+			if (this->bucketOf(du) != i)  // stale:
+				return;
+
+			Worker& worker = this->Workers[w];
+
+			if (this->Mark[u].exchange(epoch, memory_order_relaxed) != epoch)
+				worker.Done.push_back(u);
+
+			this->relax(u, du, true, worker.Buckets);
+		});
+	}
+
+	this->forEachEntry(&Worker::Done, [&](int u, int w)
+	{
+		this->relax(u, this->Tentative[u].load(memory_order_relaxed), false, this->Workers[w].Buckets);
+	});
+
+	for (Worker& worker : this->Workers)
+		this->NumSettled += (int)worker.Done.size();
+}
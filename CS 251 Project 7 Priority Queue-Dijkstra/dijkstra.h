@@ -0,0 +1,307 @@
+/*dijkstra.h*/
+
+//
+//   Single-source shortest paths over a CSRGraph, using Dijkstra's
+// algorithm on top of a Dijkstra-specific priority queue.  The queue
+// type is a template parameter: any class with the PQueue interface
+// (constructor taking the # of vertices, Reset, Push, PopMin(v, d),
+// Empty) and a KeyType typedef can be used, and the graph's weights
+// must have that same KeyType.
+//
+//   The engine owns its queue and result arrays, so one Dijkstra object
+// can answer many queries against the same graph.  Besides a full run,
+// a query can be bounded: to the vertices within a radius, or until a
+// given number of targets is settled (the nearest K of a set, or all
+// of it).  Only the vertices a query labels are reset before the next
+// one, and a bounded query stops as soon as its answer is known, so
+// its cost is proportional to the part of the graph it explores, not
+// to N.
+//
+//   After any query, a vertex is Reached iff it was settled, and then
+// its distance and predecessor are final.
+//
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+
+using namespace std;
+
+
+template <typename Queue>
+class Dijkstra
+{
+public:
+  typedef typename Queue::KeyType Distance;
+
+private:
+  const CSRGraph<Distance>& Graph;
+  Queue                     PQ;
+
+  vector<Distance>  Dist;     // best known distance of each vertex
+  vector<int>       Pred;     // predecessor on that path (-1 if none)
+  vector<char>      Flags;    // TARGET / SETTLED, for the current query
+
+  vector<int>       Touched;  // vertices labeled or marked by the current query
+  vector<int>       Order;    // vertices settled by the current query, in order
+  vector<int>       Targets;  // targets settled by the current query, in order
+
+  int   NumSettled;           // # of vertices popped by the last Run
+
+  static const char TARGET = 1;
+  static const char SETTLED = 2;
+
+  void clear();
+  void search(int source, Distance radius, size_t targetsLeft);
+
+public:
+  Dijkstra(const CSRGraph<Distance>& graph);
+
+  void Run(int source);
+  void RunWithin(int source, Distance radius);
+  void RunToTargets(int source, const vector<int>& targets, size_t count = 0, Distance radius = Infinity());
+
+  static Distance Infinity();
+
+  const vector<Distance>& Distances() const    { return this->Dist; }
+  const vector<int>&      Predecessors() const { return this->Pred; }
+
+  Distance  DistanceTo(int v) const     { return this->Dist[v]; }
+  int       PredecessorOf(int v) const  { return this->Pred[v]; }
+  bool      Reached(int v) const        { return this->Dist[v] != Infinity(); }
+  int       Settled() const             { return this->NumSettled; }
+
+  const vector<int>& SettledVertices() const  { return this->Order; }
+  const vector<int>& SettledTargets() const   { return this->Targets; }
+
+  const Queue& PriorityQueue() const    { return this->PQ; }
+};
+
+
+//
+// Constructor:
+//
+// Prepares an engine for the given graph, which must outlive the engine
+// and have non-negative edge weights (a logic_error is thrown if not).
+//
+template <typename Queue>
+Dijkstra<Queue>::Dijkstra(const CSRGraph<Distance>& graph)
+	: Graph(graph), PQ(graph.NumVertices()),
+	  Dist(graph.NumVertices(), Infinity()), Pred(graph.NumVertices(), -1), Flags(graph.NumVertices(), 0)
+{
+	if (!graph.NonNegativeWeights())
+		throw logic_error("Dijkstra: graph has a negative edge weight");
+
+	this->NumSettled = 0;
+}
+
+
+//
+// Infinity:
+//
+// Distance of a vertex that has not been reached; the largest value of
+// Distance when it has no infinity (integer distances).
+//
+template <typename Queue>
+typename Dijkstra<Queue>::Distance Dijkstra<Queue>::Infinity()
+{
+	if (numeric_limits<Distance>::has_infinity)
+		return numeric_limits<Distance>::infinity();
+	else
+		return numeric_limits<Distance>::max();
+}
+
+
+//
+// Run:
+//
+// Computes shortest paths from source to every vertex.  Afterwards
+// Distances()[v] is the length of a shortest path to v (Infinity() if
+// v is unreachable), and Predecessors()[v] the vertex before v on that
+// path (-1 for the source and unreachable vertices).
+//
+template <typename Queue>
+void Dijkstra<Queue>::Run(int source)
+{
+	if (source < 0 || source >= this->Graph.NumVertices())
+		throw logic_error("Dijkstra::Run: invalid source vertex, must be 0..N-1");
+
+	this->clear();
+	this->search(source, Infinity(), 0);
+}
+
+
+//
+// RunWithin:
+//
+// Computes shortest paths from source to the vertices at distance at
+// most radius; the others are left unreached.  Edges that lead beyond
+// the radius are not followed, so no vertex outside it is queued.
+// SettledVertices() lists the vertices found, nearest first.
+//
+template <typename Queue>
+void Dijkstra<Queue>::RunWithin(int source, Distance radius)
+{
+	if (source < 0 || source >= this->Graph.NumVertices())
+		throw logic_error("Dijkstra::RunWithin: invalid source vertex, must be 0..N-1");
+
+	this->clear();
+	this->search(source, radius, 0);
+}
+
+
+//
+// RunToTargets:
+//
+// Computes shortest paths from source until count of the given targets
+// have been settled (0, or more than there are targets: all of them),
+// or the search runs out of vertices within radius.  SettledTargets()
+// then lists the targets reached, nearest first, i.e. the nearest
+// count targets.  Vertices the search labeled but did not settle are
+// left unreached.  With no targets there is nothing to find, so nothing
+// is searched, not even the source.  Throws a logic_error if a target
+// is invalid.
+//
+template <typename Queue>
+void Dijkstra<Queue>::RunToTargets(int source, const vector<int>& targets, size_t count, Distance radius)
+{
+	int N = this->Graph.NumVertices();
+
+	if (source < 0 || source >= N)
+		throw logic_error("Dijkstra::RunToTargets: invalid source vertex, must be 0..N-1");
+
+	for (int t : targets)
+	{
+		if (t < 0 || t >= N)
+			throw logic_error("Dijkstra::RunToTargets: invalid target vertex, must be 0..N-1");
+	}
+
+	this->clear();
+
+	size_t distinct = 0;
+
+	for (int t : targets)
+	{
+		if (!(this->Flags[t] & TARGET))
+		{
+			this->Flags[t] |= TARGET;
+			this->Touched.push_back(t);
+			distinct++;
+		}
+	}
+
+	if (distinct == 0)  // targetsLeft 0 would mean a full search:
+		return;
+
+	if (count == 0 || count > distinct)
+		count = distinct;
+
+	this->search(source, radius, count);
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// resets the vertices labeled (or marked as targets) by the last query,
+// and the queue, in case the last query stopped early or was
+// interrupted by an exception:
+//
+template <typename Queue>
+void Dijkstra<Queue>::clear()
+{
+	for (int v : this->Touched)
+	{
+		this->Dist[v] = Infinity();
+		this->Pred[v] = -1;
+		this->Flags[v] = 0;
+	}
+
+	this->Touched.clear();
+	this->Order.clear();
+	this->Targets.clear();
+
+	this->NumSettled = 0;
+
+	this->PQ.Reset();
+}
+
+
+//
+// the search itself, after clear(): settles vertices from source in
+// order of distance, without following edges beyond radius, until the
+// queue is empty or targetsLeft of the marked targets have been
+// settled (0 => no targets to wait for):
+//
+template <typename Queue>
+void Dijkstra<Queue>::search(int source, Distance radius, size_t targetsLeft)
+{
+	this->Dist[source] = Distance(0);
+	this->Touched.push_back(source);
+	this->PQ.Push(source, Distance(0));
+
+	//
+	// only vertices whose distance improved are pushed, so every pop is
+	// a vertex being settled with its final distance:
+	//
+	while (!this->PQ.Empty())
+	{
+		int      u;
+		Distance du;
+
+		this->PQ.PopMin(u, du);  // du == Dist[u], without reading it:
+
+		this->NumSettled++;
+		this->Flags[u] |= SETTLED;
+		this->Order.push_back(u);
+
+		if (this->Flags[u] & TARGET)
+		{
+			this->Targets.push_back(u);
+
+			if (--targetsLeft == 0)  // the answer is complete:
+				break;
+		}
+
+		int64_t end = this->Graph.EdgesEnd(u);
+
+		for (int64_t e = this->Graph.EdgesBegin(u); e < end; ++e)
+		{
+			int      t = this->Graph.Target(e);
+			Distance nd = du + this->Graph.Weight(e);
+
+			if (nd < this->Dist[t] && !(radius < nd))
+			{
+				if (this->Dist[t] == Infinity() && !(this->Flags[t] & TARGET))  // targets are listed already:
+					this->Touched.push_back(t);
+
+				this->Dist[t] = nd;
+				this->Pred[t] = u;
+
+				this->PQ.Push(t, nd);
+			}
+		}
+	}
+
+	if (this->PQ.Empty())
+		return;
+
+	//
+	// a search stopped early leaves tentative labels on the vertices
+	// still queued, which are not final distances:
+	//
+	for (int v : this->Touched)
+	{
+		if (!(this->Flags[v] & SETTLED))
+		{
+			this->Dist[v] = Infinity();
+			this->Pred[v] = -1;
+		}
+	}
+}
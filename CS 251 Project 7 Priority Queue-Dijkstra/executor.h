@@ -0,0 +1,141 @@
+/*executor.h*/
+
+//
+//   Runs batches of independent shortest-path queries over one graph on
+// a ThreadPool.  The graph is shared read-only by all workers; each
+// worker owns its engines (and so their queues and result arrays),
+// which it reuses from one query to the next, so a query allocates
+// nothing and the queues are only Reset.  Workers claim queries one at
+// a time from a shared atomic counter, so long and short queries
+// balance out, and write each result straight into the caller's
+// preallocated output buffer.
+//
+//   The graph's reversal, which the s-t engines search backward over, is
+// built once by the executor and shared too.
+//
+//   The per-worker state is cache-line aligned and allocated by the
+// worker itself, so workers do not share cache lines (false sharing),
+// and on NUMA machines the memory is local to the worker.
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+#include "dijkstra.h"
+#include "bidijkstra.h"
+#include "threadpool.h"
+
+using namespace std;
+
+
+template <typename Queue>
+class QueryExecutor
+{
+public:
+  typedef typename Queue::KeyType Distance;
+
+private:
+  struct alignas(64) Worker
+  {
+    unique_ptr<Dijkstra<Queue>>               Single;  // for single-source queries
+    unique_ptr<BidirectionalDijkstra<Queue>>  Pair;    // for s-t queries
+  };
+
+  const CSRGraph<Distance>& Graph;
+  CSRGraph<Distance>        Reverse;   // shared by the workers' s-t engines, built on first use
+  ThreadPool                Pool;
+  vector<Worker>            Workers;
+
+public:
+  QueryExecutor(const CSRGraph<Distance>& graph, int numThreads = 0);
+
+  int  Threads() const { return this->Pool.Size(); }
+
+  void RunSources(const int* sources, size_t n, Distance* distances);
+  void RunPairs(const int* sources, const int* targets, size_t n, Distance* distances);
+};
+
+
+//
+// Constructor:
+//
+// An executor for the given graph, which must outlive it, with
+// numThreads workers (0 => one per hardware thread).  The engines are
+// created by the workers the first time they need them.
+//
+template <typename Queue>
+QueryExecutor<Queue>::QueryExecutor(const CSRGraph<Distance>& graph, int numThreads)
+	: Graph(graph), Pool(numThreads)
+{
+	this->Workers.resize(this->Pool.Size());
+}
+
+
+//
+// RunSources:
+//
+// Computes shortest paths from each of the n sources.  distances must
+// hold n * N entries: row i (entries i*N .. i*N+N-1) receives the
+// distances from sources[i] to every vertex, Dijkstra::Infinity() for
+// unreachable ones.  A logic_error is thrown if a source is invalid
+// (the other rows may then be incomplete).
+//
+template <typename Queue>
+void QueryExecutor<Queue>::RunSources(const int* sources, size_t n, Distance* distances)
+{
+	size_t         N = (size_t)this->Graph.NumVertices();
+	atomic<size_t> next(0);
+
+	this->Pool.Run([&](int w)
+	{
+		Worker& worker = this->Workers[w];
+
+		for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1))
+		{
+			if (!worker.Single)
+				worker.Single.reset(new Dijkstra<Queue>(this->Graph));
+
+			worker.Single->Run(sources[i]);
+
+			const vector<Distance>& dist = worker.Single->Distances();
+			copy(dist.begin(), dist.end(), distances + i * N);
+		}
+	});
+}
+
+
+//
+// RunPairs:
+//
+// Computes the shortest path distance from sources[i] to targets[i] for
+// i = 0..n-1 into distances[i] (BidirectionalDijkstra::Infinity() if
+// unreachable).  A logic_error is thrown if a vertex is invalid.
+//
+template <typename Queue>
+void QueryExecutor<Queue>::RunPairs(const int* sources, const int* targets, size_t n, Distance* distances)
+{
+	atomic<size_t> next(0);
+
+	if (this->Reverse.NumVertices() != this->Graph.NumVertices())
+		this->Reverse = this->Graph.Reversed();
+
+	this->Pool.Run([&](int w)
+	{
+		Worker& worker = this->Workers[w];
+
+		for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1))
+		{
+			if (!worker.Pair)
+				worker.Pair.reset(new BidirectionalDijkstra<Queue>(this->Graph, this->Reverse));
+
+			distances[i] = worker.Pair->Query(sources[i], targets[i]);
+		}
+	});
+}
@@ -0,0 +1,462 @@
+/*fixedpqueue.h*/
+
+//
+//   A PQueue for small graphs whose maximum # of vertices N is known at
+// compile time, e.g. the tiles of a routing query.  The heap and the
+// positions are stored inline in std::arrays instead of being
+// allocated, so a queue on the stack costs no allocation at all, and a
+// query over a tiny graph never touches the allocator for its queue.
+//
+//   Vertices and positions are stored in the smallest type that holds
+// 0..N-1 plus a "not queued" marker: 8 bits up to N = 254, 16 bits
+// beyond.  The positions of a 64-vertex queue thus fit in one cache
+// line, and those of a 128-vertex queue in two.
+//
+//   Every operation except Dump is constexpr, so a queue can also be
+// used at compile time (see the smallPopOrder check in bench.cpp).
+//
+//   The interface is that of PQueue, so FixedPQueue can replace it in
+// the driver and in the Dijkstra engine.  The constructor takes the
+// actual # of vertices n <= N, which only bounds the vertex ids and
+// Fill.  Arguments are checked, throwing logic_error on misuse, unless
+// the build defines PQUEUE_UNCHECKED (see pqcheck.h).
+//
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include "pqcheck.h"
+
+using namespace std;
+
+
+template <int N, int Arity = 2, typename Key = double>
+class FixedPQueue
+{
+  static_assert(N >= 1 && N < 65535, "FixedPQueue capacity must be 1..65534");
+  static_assert(Arity >= 2, "FixedPQueue arity must be at least 2");
+
+public:
+  typedef Key KeyType;
+  typedef typename conditional<(N < 255), uint8_t, uint16_t>::type IndexType;
+
+  static constexpr int MaxVertices = N;
+
+private:
+  static constexpr IndexType NOT_QUEUED = (IndexType)~(IndexType)0;  // position of a vertex not in the heap
+
+  alignas(64) array<IndexType, N>  Positions{};  // position of every vertex in the heap
+  array<IndexType, N>              Vertices{};   // vertex of the element at each heap position
+  array<Key, N>                    Keys{};       // distance of the element at each heap position
+
+  int   NumElements = 0;  // # of elements currently in the heap
+  int   Capacity = 0;     // # of vertices 0..n-1, n <= N
+
+  constexpr void place(int position, IndexType v, Key d);
+  constexpr void shiftUp(int position);
+  constexpr void shiftDown(int position);
+  constexpr int  removeTop();
+
+public:
+  constexpr explicit FixedPQueue(int n = N);  // constructor:
+
+  constexpr void Fill(Key distance);
+  constexpr void Reset();
+
+  constexpr void Push(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  constexpr void DecreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  constexpr void IncreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  constexpr int  PopMin() PQUEUE_NOEXCEPT;
+  constexpr void PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT;
+  constexpr int  Top() const PQUEUE_NOEXCEPT;
+  constexpr Key  TopDistance() const PQUEUE_NOEXCEPT;
+  constexpr bool Empty() const PQUEUE_NOEXCEPT { return this->NumElements == 0; }
+
+  // the heap is at most N elements, so the batches are plain loops:
+  constexpr void   PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT;
+  constexpr size_t PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT;
+
+  void Dump(string title);  // debugging output of contents:
+};
+
+
+//
+// Constructor:
+//
+// n is the # of vertices, numbered 0..n-1; a logic_error is thrown if
+// n is not in 0..N.
+//
+template <int N, int Arity, typename Key>
+constexpr FixedPQueue<N, Arity, Key>::FixedPQueue(int n)
+{
+	if (n < 0 || n > N)
+		throw logic_error("FixedPQueue: # of vertices must be 0..N, the fixed capacity");
+
+	this->Capacity = n;
+
+	for (int v = 0; v < N; ++v)
+		this->Positions[v] = NOT_QUEUED;
+}
+
+
+//
+// Fill:
+//
+// Initializes the queue such that all n vertices are assigned the same
+// distance.  Equal keys already form a heap, so this is a single O(n)
+// pass; with n this small there is no need for PQueue's implicit
+// queueing.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::Fill(Key distance)
+{
+	this->Reset();
+
+	for (int v = 0; v < this->Capacity; ++v)
+		this->place(v, (IndexType)v, distance);
+
+	this->NumElements = this->Capacity;
+}
+
+
+//
+// Reset:
+//
+// Empties the queue, so the same instance can serve the next query.
+// Only the positions of the vertices still queued are cleared (popped
+// vertices were cleared by PopMin), so this is O(# elements).
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::Reset()
+{
+	for (int i = 0; i < this->NumElements; ++i)
+		this->Positions[this->Vertices[i]] = NOT_QUEUED;
+
+	this->NumElements = 0;
+}
+
+
+//
+// Push:
+//
+// Inserts (vertex, distance) into the queue, or updates the distance
+// of the vertex if it is already queued; see PQueue::Push.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::Push(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to FixedPQueue::Push, must be 0..N-1");
+
+	int position = this->Positions[vertex];
+
+	if (position != NOT_QUEUED)  // vertex is currently stored in the queue:
+	{
+		if (distance < this->Keys[position])
+			this->DecreaseKey(vertex, distance);
+		else if (distance > this->Keys[position])
+			this->IncreaseKey(vertex, distance);
+
+		// else same distance, nothing to do:
+		return;
+	}
+
+	position = this->NumElements++;
+
+	this->place(position, (IndexType)vertex, distance);
+	this->shiftUp(position);
+}
+
+
+//
+// DecreaseKey:
+//
+// Lowers the distance of a vertex that is currently in the queue.
+// Throws a logic_error if the vertex is not in the queue, or if the
+// new distance is larger than the current one.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::DecreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to FixedPQueue::DecreaseKey, must be 0..N-1");
+
+	int position = this->Positions[vertex];
+
+	PQUEUE_CHECK(position != NOT_QUEUED,
+		"Vertex passed to FixedPQueue::DecreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance > this->Keys[position]),
+		"Distance passed to FixedPQueue::DecreaseKey is larger than current distance");
+
+	this->Keys[position] = distance;
+	this->shiftUp(position);
+}
+
+
+//
+// IncreaseKey:
+//
+// Raises the distance of a vertex that is currently in the queue.
+// Throws a logic_error if the vertex is not in the queue, or if the
+// new distance is smaller than the current one.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::IncreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to FixedPQueue::IncreaseKey, must be 0..N-1");
+
+	int position = this->Positions[vertex];
+
+	PQUEUE_CHECK(position != NOT_QUEUED,
+		"Vertex passed to FixedPQueue::IncreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance < this->Keys[position]),
+		"Distance passed to FixedPQueue::IncreaseKey is smaller than current distance");
+
+	this->Keys[position] = distance;
+	this->shiftDown(position);
+}
+
+
+//
+// PopMin:
+//
+// Pops (and removes) the (vertex, distance) pair at the front of the
+// queue, and returns vertex.  Throws a logic_error "stack empty!" if
+// the queue is empty (unless PQUEUE_UNCHECKED).
+//
+template <int N, int Arity, typename Key>
+constexpr int FixedPQueue<N, Arity, Key>::PopMin() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->removeTop();
+}
+
+
+//
+// PopMin(vertex, distance):
+//
+// Same as PopMin(), but also returns the popped vertex's distance.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	distance = this->Keys[0];
+	vertex = this->removeTop();
+}
+
+
+//
+// Top / TopDistance:
+//
+// The vertex PopMin would return next, and its distance, without
+// removing it.  Throws a logic_error "stack empty!" if the queue is
+// empty (unless PQUEUE_UNCHECKED).
+//
+template <int N, int Arity, typename Key>
+constexpr int FixedPQueue<N, Arity, Key>::Top() const PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->Vertices[0];
+}
+
+
+template <int N, int Arity, typename Key>
+constexpr Key FixedPQueue<N, Arity, Key>::TopDistance() const PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->Keys[0];
+}
+
+
+//
+// PushBatch:
+//
+// Pushes (vertices[i], distances[i]) for i = 0..n-1, with the same
+// meaning as n calls to Push.
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT
+{
+	for (size_t i = 0; i < n; ++i)
+		this->Push(vertices[i], distances[i]);
+}
+
+
+//
+// PopMinBatch:
+//
+// Pops up to k vertices in ascending order of distance into out[], and
+// returns how many were popped (fewer than k if the queue runs empty).
+//
+template <int N, int Arity, typename Key>
+constexpr size_t FixedPQueue<N, Arity, Key>::PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT
+{
+	size_t count = 0;
+
+	while (count < k && !this->Empty())
+		out[count++] = this->removeTop();
+
+	return count;
+}
+
+
+//
+// Dump:
+//
+// Dumps the contents of the queue to the console, in heap order; this
+// is for debugging purposes.
+//
+template <int N, int Arity, typename Key>
+void FixedPQueue<N, Arity, Key>::Dump(string title)
+{
+	cout << ">>FixedPQueue: " << title << endl;
+
+	cout << "  # elements: " << this->NumElements << endl;
+
+	if (this->Empty())  // no output:
+		return;
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	int shown = min(this->NumElements, 100);
+
+	cout << "  ";
+	for (int i = 0; i < shown; ++i)
+	{
+		cout << "(" << (int)this->Vertices[i] << "," << this->Keys[i] << ") ";
+	}
+
+	if (shown < this->NumElements)
+		cout << "...";
+
+	cout << endl;
+
+	cout << "  Positions: ";
+	for (int v = 0, listed = 0; v < this->Capacity && listed < shown; ++v)
+	{
+		if (this->Positions[v] != NOT_QUEUED)
+		{
+			cout << "(" << v << "@" << (int)this->Positions[v] << ") ";
+			listed++;
+		}
+	}
+
+	if (shown < this->NumElements)
+		cout << "...";
+
+	cout << endl;
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// stores (v, d) at the given heap position and records the position:
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::place(int position, IndexType v, Key d)
+{
+	this->Keys[position] = d;
+	this->Vertices[position] = v;
+	this->Positions[v] = (IndexType)position;
+}
+
+
+//
+// moves the element at position up until its parent is not larger,
+// shifting the parents down into the hole instead of swapping:
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::shiftUp(int position)
+{
+	Key       d = this->Keys[position];
+	IndexType v = this->Vertices[position];
+
+	while (position > 0)
+	{
+		int parent = (position - 1) / Arity;
+
+		if (!(d < this->Keys[parent]))
+			break;
+
+		this->place(position, this->Vertices[parent], this->Keys[parent]);
+		position = parent;
+	}
+
+	this->place(position, v, d);
+}
+
+
+//
+// moves the element at position down until no child is smaller, moving
+// the smallest child up into the hole at each level:
+//
+template <int N, int Arity, typename Key>
+constexpr void FixedPQueue<N, Arity, Key>::shiftDown(int position)
+{
+	Key       d = this->Keys[position];
+	IndexType v = this->Vertices[position];
+
+	for (;;)
+	{
+		int first = position * Arity + 1;
+
+		if (first >= this->NumElements)
+			break;
+
+		int last = min(first + Arity, this->NumElements);
+		int best = first;
+
+		for (int c = first + 1; c < last; ++c)
+		{
+			if (this->Keys[c] < this->Keys[best])
+				best = c;
+		}
+
+		if (!(this->Keys[best] < d))
+			break;
+
+		this->place(position, this->Vertices[best], this->Keys[best]);
+		position = best;
+	}
+
+	this->place(position, v, d);
+}
+
+
+//
+// removes the element at the front, which must exist, and returns its
+// vertex:
+//
+template <int N, int Arity, typename Key>
+constexpr int FixedPQueue<N, Arity, Key>::removeTop()
+{
+	int v = this->Vertices[0];
+
+	this->Positions[v] = NOT_QUEUED;
+	this->NumElements--;
+
+	if (this->NumElements > 0)
+	{
+		this->place(0, this->Vertices[this->NumElements], this->Keys[this->NumElements]);
+		this->shiftDown(0);
+	}
+
+	return v;
+}
@@ -0,0 +1,376 @@
+/*graph.h*/
+
+//
+//   A directed, weighted graph stored in compressed sparse row (CSR)
+// form.  The out-edges of vertex v occupy the index range
+// Offsets[v] .. Offsets[v+1]-1 of the Targets and Weights arrays, so
+// relaxing a vertex reads its edges sequentially from memory.
+//
+//   Vertices are numbered 0..N-1; the edge weight type is a template
+// parameter so integer-weighted graphs can be paired with an integer
+// keyed priority queue.
+//
+//   The arrays are either owned by the graph, or live in storage the
+// graph keeps alive, e.g. a memory-mapped graph file (graphfile.h), so
+// a graph can be used in place without copying.
+//
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <exception>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+
+//
+// an edge From -> To, used to build a CSRGraph from an edge list:
+//
+template <typename W>
+struct GraphEdge
+{
+  int  From;
+  int  To;
+  W    Weight;
+};
+
+
+template <typename W = double>
+class CSRGraph
+{
+private:
+  int      VertexCount;
+  int64_t  EdgeCount;
+
+  //
+  // the CSR arrays, pointing into the owned vectors below:
+  //
+  const int64_t *Offsets;   // N+1 entries
+  const int     *Targets;   // M entries
+  const W       *Weights;   // M entries
+
+  vector<int64_t>  OwnedOffsets;
+  vector<int>      OwnedTargets;
+  vector<W>        OwnedWeights;
+
+  shared_ptr<const void>  Storage;  // keeps external arrays alive (else null)
+
+  bool  NonNegative;  // no weight is < 0, see NonNegativeWeights()
+
+  void validate();
+
+public:
+  typedef W WeightType;
+
+  CSRGraph();  // empty graph:
+  CSRGraph(int N, vector<int64_t> offsets, vector<int> targets, vector<W> weights);
+  CSRGraph(int N, int64_t M, const int64_t* offsets, const int* targets, const W* weights,
+           bool nonNegative, shared_ptr<const void> storage, bool check = true);
+
+  // the arrays point into this object, so copying is not allowed:
+  CSRGraph(const CSRGraph& other) = delete;
+  CSRGraph& operator=(const CSRGraph& other) = delete;
+  CSRGraph(CSRGraph&& other) = default;
+  CSRGraph& operator=(CSRGraph&& other) = default;
+
+  static CSRGraph FromEdges(int N, const vector<GraphEdge<W>>& edges);
+  static bool AllNonNegative(const W* weights, int64_t M);
+
+  CSRGraph Reversed() const;
+  CSRGraph Permuted(const vector<int>& newIds) const;
+
+  int      NumVertices() const { return this->VertexCount; }
+  int64_t  NumEdges() const    { return this->EdgeCount; }
+
+  int64_t  EdgesBegin(int v) const  { return this->Offsets[v]; }
+  int64_t  EdgesEnd(int v) const    { return this->Offsets[v + 1]; }
+  int      Target(int64_t e) const  { return this->Targets[e]; }
+  W        Weight(int64_t e) const  { return this->Weights[e]; }
+
+  //
+  // true if no edge weight is negative, as the shortest path engines
+  // require; found once when the graph is built (always true for an
+  // unsigned W), so the engines don't rescan the weights:
+  //
+  bool     NonNegativeWeights() const  { return this->NonNegative; }
+
+  const int64_t* OffsetArray() const { return this->Offsets; }
+  const int*     TargetArray() const { return this->Targets; }
+  const W*       WeightArray() const { return this->Weights; }
+};
+
+
+//
+// Default constructor:
+//
+// An empty graph with no vertices.
+//
+template <typename W>
+CSRGraph<W>::CSRGraph()
+	: OwnedOffsets(1, 0)
+{
+	this->VertexCount = 0;
+	this->EdgeCount = 0;
+
+	this->Offsets = this->OwnedOffsets.data();
+	this->Targets = nullptr;
+	this->Weights = nullptr;
+
+	this->NonNegative = true;
+}
+
+
+//
+// Constructor:
+//
+// Takes ownership of already built CSR arrays: offsets must have N+1
+// entries, starting at 0 and non-decreasing, and targets / weights one
+// entry per edge.  Throws a logic_error if the arrays are inconsistent.
+//
+template <typename W>
+CSRGraph<W>::CSRGraph(int N, vector<int64_t> offsets, vector<int> targets, vector<W> weights)
+	: OwnedOffsets(std::move(offsets)), OwnedTargets(std::move(targets)), OwnedWeights(std::move(weights))
+{
+	if (N < 0 || this->OwnedOffsets.size() != (size_t)N + 1)
+		throw logic_error("CSRGraph: offsets must have N+1 entries");
+	if (this->OwnedWeights.size() != this->OwnedTargets.size())
+		throw logic_error("CSRGraph: targets and weights must have one entry per edge");
+
+	this->VertexCount = N;
+	this->EdgeCount = (int64_t)this->OwnedTargets.size();
+
+	this->Offsets = this->OwnedOffsets.data();
+	this->Targets = this->OwnedTargets.data();
+	this->Weights = this->OwnedWeights.data();
+
+	this->validate();
+
+	this->NonNegative = AllNonNegative(this->Weights, this->EdgeCount);
+}
+
+
+//
+// Constructor:
+//
+// Uses CSR arrays that live elsewhere, without copying them: N+1
+// offsets, and M targets and weights.  storage (e.g. the mapping the
+// arrays point into) is kept alive as long as the graph, or any graph
+// moved from it.  nonNegative is what the caller knows about the
+// weights, e.g. from a graph file header (see NonNegativeWeights).  If
+// check is true the arrays are validated like in the constructor
+// above, which reads all of them, and nonNegative is verified; if false
+// only the first and last offsets are checked, so the rest of the
+// arrays is not touched until used.
+//
+template <typename W>
+CSRGraph<W>::CSRGraph(int N, int64_t M, const int64_t* offsets, const int* targets, const W* weights,
+                      bool nonNegative, shared_ptr<const void> storage, bool check)
+	: Storage(std::move(storage))
+{
+	if (N < 0 || M < 0)
+		throw logic_error("CSRGraph: negative # of vertices or edges");
+
+	this->VertexCount = N;
+	this->EdgeCount = M;
+
+	this->Offsets = offsets;
+	this->Targets = targets;
+	this->Weights = weights;
+
+	if (check)
+		this->validate();
+	else if (this->Offsets[0] != 0 || this->Offsets[N] != M)
+		throw logic_error("CSRGraph: offsets must run from 0 to # of edges");
+
+	if (check && nonNegative != AllNonNegative(this->Weights, M))
+		throw logic_error("CSRGraph: weights do not match the given sign");
+
+	this->NonNegative = nonNegative;
+}
+
+
+//
+// FromEdges:
+//
+// Builds a CSR graph over vertices 0..N-1 from an edge list, in any
+// order.  Edges leaving the same vertex keep their relative order.
+//
+template <typename W>
+CSRGraph<W> CSRGraph<W>::FromEdges(int N, const vector<GraphEdge<W>>& edges)
+{
+	if (N < 0)
+		throw logic_error("CSRGraph::FromEdges: negative # of vertices");
+
+	vector<int64_t> offsets((size_t)N + 1, 0);
+	vector<int>     targets(edges.size());
+	vector<W>       weights(edges.size());
+
+	//
+	// counting sort by source vertex: count out-degrees, prefix sum into
+	// offsets, then scatter:
+	//
+	for (const GraphEdge<W>& e : edges)
+	{
+		if (e.From < 0 || e.From >= N || e.To < 0 || e.To >= N)
+			throw logic_error("CSRGraph::FromEdges: edge endpoint out of range 0..N-1");
+
+		offsets[e.From + 1]++;
+	}
+
+	for (int v = 0; v < N; ++v)
+		offsets[v + 1] += offsets[v];
+
+	vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+
+	for (const GraphEdge<W>& e : edges)
+	{
+		int64_t slot = next[e.From]++;
+
+		targets[slot] = e.To;
+		weights[slot] = e.Weight;
+	}
+
+	return CSRGraph<W>(N, std::move(offsets), std::move(targets), std::move(weights));
+}
+
+
+//
+// AllNonNegative:
+//
+// True if none of the M weights is negative; for an unsigned W that is
+// known without reading them.
+//
+template <typename W>
+bool CSRGraph<W>::AllNonNegative(const W* weights, int64_t M)
+{
+	if constexpr (is_unsigned<W>::value)
+		return true;
+	else
+	{
+		for (int64_t e = 0; e < M; ++e)
+		{
+			if (weights[e] < W(0))
+				return false;
+		}
+
+		return true;
+	}
+}
+
+
+//
+// Reversed:
+//
+// The graph with every edge u -> v turned into v -> u, i.e. the in-edges
+// of each vertex in CSR form, for searches that run backward from a
+// target.
+//
+template <typename W>
+CSRGraph<W> CSRGraph<W>::Reversed() const
+{
+	int N = this->VertexCount;
+
+	vector<int64_t> offsets((size_t)N + 1, 0);
+	vector<int>     targets((size_t)this->EdgeCount);
+	vector<W>       weights((size_t)this->EdgeCount);
+
+	for (int64_t e = 0; e < this->EdgeCount; ++e)
+		offsets[this->Targets[e] + 1]++;
+
+	for (int v = 0; v < N; ++v)
+		offsets[v + 1] += offsets[v];
+
+	vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+
+	for (int u = 0; u < N; ++u)
+	{
+		for (int64_t e = this->Offsets[u]; e < this->Offsets[u + 1]; ++e)
+		{
+			int64_t slot = next[this->Targets[e]]++;
+
+			targets[slot] = u;
+			weights[slot] = this->Weights[e];
+		}
+	}
+
+	return CSRGraph<W>(N, std::move(offsets), std::move(targets), std::move(weights));
+}
+
+
+//
+// Permuted:
+//
+// The same graph with its vertices renumbered, original vertex v
+// becoming newIds[v], which must be a permutation of 0..N-1 (a
+// logic_error is thrown if not).  The edges of a vertex keep their
+// order.  See vertexorder.h for orders that improve locality.
+//
+template <typename W>
+CSRGraph<W> CSRGraph<W>::Permuted(const vector<int>& newIds) const
+{
+	int N = this->VertexCount;
+
+	if (newIds.size() != (size_t)N)
+		throw logic_error("CSRGraph::Permuted: permutation must have N entries");
+
+	vector<int64_t> offsets((size_t)N + 1, 0);
+	vector<int>     targets((size_t)this->EdgeCount);
+	vector<W>       weights((size_t)this->EdgeCount);
+
+	for (int u = 0; u < N; ++u)
+	{
+		int id = newIds[u];
+
+		if (id < 0 || id >= N || offsets[id + 1] != 0)
+			throw logic_error("CSRGraph::Permuted: not a permutation of 0..N-1");
+
+		offsets[id + 1] = this->Offsets[u + 1] - this->Offsets[u] + 1;  // + 1 marks id as taken:
+	}
+
+	for (int v = 0; v < N; ++v)
+		offsets[v + 1] += offsets[v] - 1;
+
+	for (int u = 0; u < N; ++u)
+	{
+		int64_t slot = offsets[newIds[u]];
+
+		for (int64_t e = this->Offsets[u]; e < this->Offsets[u + 1]; ++e, ++slot)
+		{
+			targets[slot] = newIds[this->Targets[e]];
+			weights[slot] = this->Weights[e];
+		}
+	}
+
+	return CSRGraph<W>(N, std::move(offsets), std::move(targets), std::move(weights));
+}
+
+
+//
+// validate:
+//
+// Checks the CSR invariants, throwing a logic_error on failure.
+//
+template <typename W>
+void CSRGraph<W>::validate()
+{
+	if (this->Offsets[0] != 0 || this->Offsets[this->VertexCount] != this->EdgeCount)
+		throw logic_error("CSRGraph: offsets must run from 0 to # of edges");
+
+	for (int v = 0; v < this->VertexCount; ++v)
+	{
+		if (this->Offsets[v + 1] < this->Offsets[v])
+			throw logic_error("CSRGraph: offsets must be non-decreasing");
+	}
+
+	for (int64_t e = 0; e < this->EdgeCount; ++e)
+	{
+		if (this->Targets[e] < 0 || this->Targets[e] >= this->VertexCount)
+			throw logic_error("CSRGraph: edge target out of range 0..N-1");
+	}
+}
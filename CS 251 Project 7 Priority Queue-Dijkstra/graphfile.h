@@ -0,0 +1,206 @@
+/*graphfile.h*/
+
+//
+//   A binary on-disk format for CSRGraph, which can be memory-mapped
+// and used in place: loading a graph is a header check, and its pages
+// are read from disk (or shared from the page cache) as the queries
+// touch them, with no parsing and no copying.
+//
+//   Layout (in host byte order, see FILE_BYTE_ORDER_MARK in mappedfile.h):
+//
+//     GraphFileHeader   64 bytes
+//     offsets           int64_t[N+1]   at OffsetsAt
+//     targets           int32_t[M]     at TargetsAt
+//     weights           W[M]           at WeightsAt
+//
+// Every array starts on a 64-byte boundary, so it can be used directly
+// from the mapping.  The header records the weight type, so a file is
+// only loaded as a graph of the type it was saved as.
+//
+//   Version history:
+//     1 -- initial version.
+//     2 -- NumVertices narrowed to 32 bits (a CSRGraph has int vertex
+//          ids) to make room for Flags, which records whether every
+//          weight is non-negative, so a mapped graph is not scanned for
+//          negative weights.  Version 1 files are still loaded; their
+//          weights are scanned once when mapped.
+//
+
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+#include "mappedfile.h"
+
+using namespace std;
+
+
+struct GraphFileHeader
+{
+  char      Magic[8];      // "PQCSRGR\0"
+  uint32_t  Version;       // GRAPH_FILE_VERSION
+  uint32_t  ByteOrder;     // FILE_BYTE_ORDER_MARK
+  uint32_t  WeightType;    // GraphWeightType<W>::Code
+  uint32_t  WeightSize;    // sizeof(W)
+  int32_t   NumVertices;
+  uint32_t  Flags;         // GRAPH_FILE_* flags below (0 in version 1)
+  int64_t   NumEdges;
+  uint64_t  OffsetsAt;     // byte positions of the arrays in the file
+  uint64_t  TargetsAt;
+  uint64_t  WeightsAt;
+};
+
+static_assert(sizeof(GraphFileHeader) == 64, "graph file header must be 64 bytes");
+
+const uint32_t GRAPH_FILE_VERSION = 2;
+const uint64_t GRAPH_FILE_ALIGNMENT = 64;
+
+const uint32_t GRAPH_FILE_NON_NEGATIVE = 1;  // Flags: no weight is < 0
+
+
+//
+// the weight type codes stored in the header:
+//
+template <typename W> struct GraphWeightType;
+
+template <> struct GraphWeightType<double>   { static const uint32_t Code = 1; };
+template <> struct GraphWeightType<float>    { static const uint32_t Code = 2; };
+template <> struct GraphWeightType<int32_t>  { static const uint32_t Code = 3; };
+template <> struct GraphWeightType<uint32_t> { static const uint32_t Code = 4; };
+template <> struct GraphWeightType<int64_t>  { static const uint32_t Code = 5; };
+template <> struct GraphWeightType<uint64_t> { static const uint32_t Code = 6; };
+
+
+//
+// position of the next array after bytes, on an alignment boundary:
+//
+inline uint64_t GraphFileAlign(uint64_t bytes)
+{
+	return (bytes + GRAPH_FILE_ALIGNMENT - 1) & ~(GRAPH_FILE_ALIGNMENT - 1);
+}
+
+
+//
+// SaveGraph:
+//
+// Writes the graph to path in the binary format.  Throws a logic_error
+// if the file cannot be written.
+//
+template <typename W>
+void SaveGraph(const CSRGraph<W>& graph, const string& path)
+{
+	int64_t N = graph.NumVertices();
+	int64_t M = graph.NumEdges();
+
+	GraphFileHeader header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.Magic, "PQCSRGR", 8);
+	header.Version = GRAPH_FILE_VERSION;
+	header.ByteOrder = FILE_BYTE_ORDER_MARK;
+	header.WeightType = GraphWeightType<W>::Code;
+	header.WeightSize = sizeof(W);
+	header.NumVertices = (int32_t)N;
+	header.Flags = graph.NonNegativeWeights() ? GRAPH_FILE_NON_NEGATIVE : 0;
+	header.NumEdges = M;
+	header.OffsetsAt = GraphFileAlign(sizeof(GraphFileHeader));
+	header.TargetsAt = GraphFileAlign(header.OffsetsAt + (N + 1) * sizeof(int64_t));
+	header.WeightsAt = GraphFileAlign(header.TargetsAt + M * sizeof(int));
+
+	ofstream file(path, ios::binary | ios::trunc);
+
+	if (!file.good())
+		throw logic_error("SaveGraph: unable to create '" + path + "'");
+
+	uint64_t written = 0;
+
+	auto write = [&](uint64_t at, const void* data, uint64_t bytes)
+	{
+		static const char padding[GRAPH_FILE_ALIGNMENT] = { 0 };
+
+		file.write(padding, (streamsize)(at - written));
+		file.write((const char*)data, (streamsize)bytes);
+		written = at + bytes;
+	};
+
+	write(0, &header, sizeof(header));
+	write(header.OffsetsAt, graph.OffsetArray(), (N + 1) * sizeof(int64_t));
+	write(header.TargetsAt, graph.TargetArray(), M * sizeof(int));
+	write(header.WeightsAt, graph.WeightArray(), M * sizeof(W));
+
+	file.close();
+
+	if (file.fail())
+		throw logic_error("SaveGraph: unable to write '" + path + "'");
+}
+
+
+//
+// MapGraph:
+//
+// Maps the graph file at path and returns a graph that uses its arrays
+// in place; the mapping lasts as long as the graph.  The header is
+// checked (format, version, byte order, weight type, and that the
+// arrays fit in the file); if check is true the whole graph is also
+// validated, which reads every page of the file.  Throws a logic_error
+// if the file cannot be used.
+//
+template <typename W>
+CSRGraph<W> MapGraph(const string& path, bool check = false)
+{
+	shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+
+	const char* base = file->Data();
+	uint64_t    size = file->Size();
+
+	GraphFileHeader header;
+
+	if (size < sizeof(header))
+		throw logic_error("MapGraph: '" + path + "' is not a graph file");
+
+	memcpy(&header, base, sizeof(header));
+
+	if (memcmp(header.Magic, "PQCSRGR", 8) != 0)
+		throw logic_error("MapGraph: '" + path + "' is not a graph file");
+	if (header.Version != GRAPH_FILE_VERSION && header.Version != 1)
+		throw logic_error("MapGraph: '" + path + "' has an unsupported version");
+	if (header.ByteOrder != FILE_BYTE_ORDER_MARK)
+		throw logic_error("MapGraph: '" + path + "' was written with a different byte order");
+	if (header.WeightType != GraphWeightType<W>::Code || header.WeightSize != sizeof(W))
+		throw logic_error("MapGraph: '" + path + "' has a different weight type");
+
+	int64_t N = header.NumVertices;
+	int64_t M = header.NumEdges;
+
+	if (N < 0 || N >= INT32_MAX || M < 0 || (uint64_t)M > size
+		|| (header.Version == 1 && header.Flags != 0))  // version 1: high half of a 64-bit N
+		throw logic_error("MapGraph: '" + path + "' has an invalid # of vertices or edges");
+
+	if (header.OffsetsAt % GRAPH_FILE_ALIGNMENT != 0 || header.TargetsAt % GRAPH_FILE_ALIGNMENT != 0
+		|| header.WeightsAt % GRAPH_FILE_ALIGNMENT != 0
+		|| header.OffsetsAt > size || (N + 1) * sizeof(int64_t) > size - header.OffsetsAt
+		|| header.TargetsAt > size || M * sizeof(int) > size - header.TargetsAt
+		|| header.WeightsAt > size || M * sizeof(W) > size - header.WeightsAt)
+		throw logic_error("MapGraph: '" + path + "' is truncated or corrupt");
+
+	const W* weights = (const W*)(base + header.WeightsAt);
+
+	//
+	// version 1 files don't record the sign of the weights, so have to
+	// be scanned:
+	//
+	bool nonNegative = (header.Version == 1) ? CSRGraph<W>::AllNonNegative(weights, M)
+	                                         : (header.Flags & GRAPH_FILE_NON_NEGATIVE) != 0;
+
+	return CSRGraph<W>((int)N, M,
+		(const int64_t*)(base + header.OffsetsAt),
+		(const int*)(base + header.TargetsAt),
+		weights, nonNegative, file, check);
+}
@@ -0,0 +1,191 @@
+/*graphgen.h*/
+
+//
+//   Generators for the graphs Dijkstra workloads are benchmarked on,
+// each with integer weights drawn uniformly from 1..maxWeight (so the
+// same graph can be built for integer-keyed queues):
+//
+//   grid       -- a rows x cols grid, each vertex linked both ways to its
+//                 4 neighbours, like a road network: low degree, large
+//                 diameter, and a queue that stays small;
+//   power-law  -- preferential attachment (Barabasi-Albert), a few hubs
+//                 of very high degree and a small diameter, like social
+//                 or web graphs;
+//   random     -- G(n, m), m edges between uniformly random endpoints;
+//   dense      -- every vertex linked to every other one, so nearly all
+//                 relaxations are decrease-keys.
+//
+//   Each generator draws from the given engine only, so a seeded engine
+// reproduces the same graph for any weight type.
+//
+
+#pragma once
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+
+using namespace std;
+
+
+//
+// GridGraph:
+//
+// A rows x cols grid, vertex r * cols + c at row r and column c, with
+// an edge each way between horizontal and vertical neighbours; both
+// directions of a road get the same weight.
+//
+template <typename W>
+CSRGraph<W> GridGraph(int rows, int cols, mt19937& gen, int maxWeight = 100)
+{
+	if (rows < 1 || cols < 1 || (int64_t)rows * cols > numeric_limits<int>::max())
+		throw logic_error("GridGraph: invalid grid size");
+
+	uniform_int_distribution<int> weightDis(1, maxWeight);
+
+	vector<GraphEdge<W>> edges;
+	edges.reserve(4 * (size_t)rows * cols);
+
+	for (int r = 0; r < rows; ++r)
+	{
+		for (int c = 0; c < cols; ++c)
+		{
+			int v = r * cols + c;
+
+			if (c + 1 < cols)
+			{
+				W weight = (W)weightDis(gen);
+
+				edges.push_back({ v, v + 1, weight });
+				edges.push_back({ v + 1, v, weight });
+			}
+
+			if (r + 1 < rows)
+			{
+				W weight = (W)weightDis(gen);
+
+				edges.push_back({ v, v + cols, weight });
+				edges.push_back({ v + cols, v, weight });
+			}
+		}
+	}
+
+	return CSRGraph<W>::FromEdges(rows * cols, edges);
+}
+
+
+//
+// PowerLawGraph:
+//
+// N vertices added one at a time, each linked both ways to degree / 2
+// earlier vertices chosen with probability proportional to their
+// degree, so the average out-degree is about degree and the degrees
+// follow a power law.  The first vertices form a small clique to start
+// from.
+//
+template <typename W>
+CSRGraph<W> PowerLawGraph(int N, int degree, mt19937& gen, int maxWeight = 100)
+{
+	if (N < 1 || degree < 2)
+		throw logic_error("PowerLawGraph: invalid # of vertices or degree");
+
+	int links = degree / 2;
+	int start = min(N, links + 1);
+
+	uniform_int_distribution<int> weightDis(1, maxWeight);
+
+	vector<GraphEdge<W>> edges;
+	vector<int>          endpoints;  // every vertex once per edge end, for degree-biased picks
+
+	edges.reserve(2 * (size_t)N * links);
+	endpoints.reserve(2 * (size_t)N * links);
+
+	auto link = [&](int u, int v)
+	{
+		W weight = (W)weightDis(gen);
+
+		edges.push_back({ u, v, weight });
+		edges.push_back({ v, u, weight });
+		endpoints.push_back(u);
+		endpoints.push_back(v);
+	};
+
+	for (int u = 0; u < start; ++u)
+	{
+		for (int v = u + 1; v < start; ++v)
+			link(u, v);
+	}
+
+	for (int v = start; v < N; ++v)
+	{
+		uniform_int_distribution<size_t> endpointDis(0, endpoints.size() - 1);
+
+		for (int i = 0; i < links; ++i)
+			link(v, endpoints[endpointDis(gen)]);
+	}
+
+	return CSRGraph<W>::FromEdges(N, edges);
+}
+
+
+//
+// RandomGraph:
+//
+// G(n, m): M directed edges between uniformly random endpoints (self
+// loops and parallel edges included).
+//
+template <typename W>
+CSRGraph<W> RandomGraph(int N, int64_t M, mt19937& gen, int maxWeight = 100)
+{
+	if (N < 1 || M < 0)
+		throw logic_error("RandomGraph: invalid # of vertices or edges");
+
+	uniform_int_distribution<int> vertexDis(0, N - 1);
+	uniform_int_distribution<int> weightDis(1, maxWeight);
+
+	vector<GraphEdge<W>> edges((size_t)M);
+
+	for (GraphEdge<W>& e : edges)
+	{
+		e.From = vertexDis(gen);
+		e.To = vertexDis(gen);
+		e.Weight = (W)weightDis(gen);
+	}
+
+	return CSRGraph<W>::FromEdges(N, edges);
+}
+
+
+//
+// DenseGraph:
+//
+// The complete directed graph on N vertices, N * (N-1) edges.
+//
+template <typename W>
+CSRGraph<W> DenseGraph(int N, mt19937& gen, int maxWeight = 100)
+{
+	if (N < 1 || (int64_t)N * (N - 1) > (int64_t)1 << 31)
+		throw logic_error("DenseGraph: invalid # of vertices");
+
+	uniform_int_distribution<int> weightDis(1, maxWeight);
+
+	vector<GraphEdge<W>> edges;
+	edges.reserve((size_t)N * (N - 1));
+
+	for (int u = 0; u < N; ++u)
+	{
+		for (int v = 0; v < N; ++v)
+		{
+			if (u != v)
+				edges.push_back({ u, v, (W)weightDis(gen) });
+		}
+	}
+
+	return CSRGraph<W>::FromEdges(N, edges);
+}
@@ -0,0 +1,478 @@
+/*lazypqueue.h*/
+
+//
+//   A "lazy deletion" priority queue with the same interface as PQueue.
+// Instead of tracking where every vertex sits in the heap, Push always
+// appends a new (vertex, distance) entry, and remembers the vertex's
+// latest distance.  Entries that no longer match a vertex's latest
+// distance are stale and are discarded when they reach the front.
+//
+//   This takes the Positions updates out of every sift step, at the
+// cost of a heap that can hold several entries per vertex.  Sparse
+// graphs, where few vertices are ever improved, tend to favour this
+// queue; dense graphs with many improvements favour the indexed PQueue.
+//
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+
+#include "pqcheck.h"
+
+using namespace std;
+
+
+template <int Arity = 2, typename Key = double>
+class LazyPQueue
+{
+  static_assert(Arity >= 2, "LazyPQueue arity must be at least 2");
+
+private:
+  vector<Key>   Keys;       // heap entries, distances
+  vector<int>   Vertices;   // and vertices (may repeat)
+
+  vector<Key>   Latest;     // latest distance pushed for every vertex
+  vector<char>  Queued;     // is the vertex's latest entry still queued?
+
+  int   NumLive;            // # of vertices currently queued
+  int   Capacity;           // max # of vertices we can support
+
+  void shiftUp(int position);
+  void shiftDown(int position);
+  void removeTop();
+  bool queue(int vertex, Key distance);
+  void dropStale();
+
+public:
+  typedef Key KeyType;
+
+  LazyPQueue(int N);  // constructor:
+
+  void Fill(Key distance);
+  void Reset();
+
+  void Push(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  void DecreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT { this->Push(vertex, distance); }
+  void IncreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT { this->Push(vertex, distance); }
+  int  PopMin() PQUEUE_NOEXCEPT;
+  void PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT;
+  int  Top() PQUEUE_NOEXCEPT;
+  Key  TopDistance() PQUEUE_NOEXCEPT;
+  bool Empty() PQUEUE_NOEXCEPT;
+
+  void   PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT;
+  size_t PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT;
+
+  int  Entries() { return (int)this->Keys.size(); }  // live + stale:
+
+  void Dump(string title);  // debugging output of contents:
+};
+
+
+//
+// Constructor:
+//
+// N is the # of vertices, numbered 0..N-1.  The heap itself grows as
+// needed, since a vertex can have several entries.
+//
+template <int Arity, typename Key>
+LazyPQueue<Arity, Key>::LazyPQueue(int N)
+	: Latest(N), Queued(N, 0)
+{
+	this->NumLive = 0;
+	this->Capacity = N;
+}
+
+
+//
+// Fill:
+//
+// Queues all N vertices with the same distance, replacing the current
+// contents.  A heap of equal keys needs no sifting.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::Fill(Key distance)
+{
+	this->Keys.assign(this->Capacity, distance);
+	this->Vertices.resize(this->Capacity);
+
+	for (int v = 0; v < this->Capacity; ++v)
+	{
+		this->Vertices[v] = v;
+		this->Latest[v] = distance;
+		this->Queued[v] = 1;
+	}
+
+	this->NumLive = this->Capacity;
+}
+
+
+//
+// Reset:
+//
+// Empties the queue, so the same instance can serve the next query.
+// Only the vertices with an entry in the heap are cleared, so the cost
+// is proportional to what the last query touched, not to N.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::Reset()
+{
+	for (int v : this->Vertices)
+		this->Queued[v] = 0;
+
+	this->Keys.clear();
+	this->Vertices.clear();
+
+	this->NumLive = 0;
+}
+
+
+//
+// Push:
+//
+// Queues (vertex, distance), replacing any distance the vertex is
+// already queued with; the old entry becomes stale.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::Push(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to LazyPQueue::Push, must be 0..N-1");
+
+	if (this->queue(vertex, distance))
+		this->shiftUp((int)this->Keys.size() - 1);
+}
+
+
+//
+// PushBatch:
+//
+// Pushes (vertices[i], distances[i]) for i = 0..n-1, with the same
+// meaning as n calls to Push.  A batch that is large relative to the
+// heap is appended without sifting, and the heap is then rebuilt
+// bottom-up.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT
+{
+	size_t total = this->Keys.size() + n;
+	size_t depth = 1;
+
+	for (size_t m = total; m > (size_t)Arity; m /= Arity)
+		depth++;
+
+	if (n * depth < total)  // sifting each entry is cheaper:
+	{
+		for (size_t i = 0; i < n; ++i)
+			this->Push(vertices[i], distances[i]);
+
+		return;
+	}
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		PQUEUE_CHECK(vertices[i] >= 0 && vertices[i] < this->Capacity,
+			"Invalid vertex passed to LazyPQueue::PushBatch, must be 0..N-1");
+
+		this->queue(vertices[i], distances[i]);
+	}
+
+	int entries = (int)this->Keys.size();
+
+	if (entries < 2)
+		return;
+
+	for (int i = (entries - 2) / Arity; i >= 0; --i)  // from the last parent:
+		this->shiftDown(i);
+}
+
+
+//
+// PopMinBatch:
+//
+// Pops up to k vertices in ascending order of distance into out[], and
+// returns how many were popped (fewer than k if the queue runs empty).
+//
+template <int Arity, typename Key>
+size_t LazyPQueue<Arity, Key>::PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT
+{
+	size_t count = 0;
+
+	while (count < k && !this->Empty())
+	{
+		out[count] = this->PopMin();
+		count++;
+	}
+
+	return count;
+}
+
+
+//
+// PopMin:
+//
+// Pops the vertex with the smallest distance, discarding any stale
+// entries in front of it.  Throws a logic_error "stack empty!" if no
+// vertex is queued.
+//
+template <int Arity, typename Key>
+int LazyPQueue<Arity, Key>::PopMin() PQUEUE_NOEXCEPT
+{
+	int v;
+	Key d;
+
+	this->PopMin(v, d);
+
+	return v;
+}
+
+
+//
+// PopMin(vertex, distance):
+//
+// Same as PopMin(), but also returns the popped vertex's distance.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	this->dropStale();
+
+	vertex = this->Vertices[0];
+	distance = this->Keys[0];
+
+	this->removeTop();
+
+	this->Queued[vertex] = 0;
+	this->NumLive--;
+}
+
+
+//
+// Top / TopDistance:
+//
+// The vertex PopMin would return next, and its distance, without
+// removing it; stale entries in front of it are discarded.  Throws a
+// logic_error "stack empty!" if no vertex is queued.
+//
+template <int Arity, typename Key>
+int LazyPQueue<Arity, Key>::Top() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	this->dropStale();
+
+	return this->Vertices[0];
+}
+
+
+template <int Arity, typename Key>
+Key LazyPQueue<Arity, Key>::TopDistance() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	this->dropStale();
+
+	return this->Keys[0];
+}
+
+
+//
+// Empty:
+//
+// Returns true if no vertex is queued (stale entries do not count).
+//
+template <int Arity, typename Key>
+bool LazyPQueue<Arity, Key>::Empty() PQUEUE_NOEXCEPT
+{
+	return (this->NumLive == 0);
+}
+
+
+//
+// Dump:
+//
+// Dumps the live entries to the console, in heap order; this is for
+// debugging purposes.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::Dump(string title)
+{
+	cout << ">>LazyPQueue: " << title << endl;
+
+	cout << "  # elements: " << this->NumLive << endl;
+	cout << "  # entries (incl. stale): " << this->Keys.size() << endl;
+
+	if (this->Empty())  // no output:
+		return;
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	cout << "  ";
+
+	int printed = 0;
+
+	for (size_t i = 0; i < this->Keys.size() && printed < 100; ++i)
+	{
+		int v = this->Vertices[i];
+
+		if (this->Queued[v] && this->Keys[i] == this->Latest[v])
+		{
+			cout << "(" << v << "," << this->Keys[i] << ") ";
+			printed++;
+		}
+	}
+
+	if (printed < this->NumLive)
+		cout << "...";
+
+	cout << endl;
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// queue:
+//
+// Appends an entry for (vertex, distance) without sifting, unless the
+// vertex is already queued with that distance; returns true if an
+// entry was appended.
+//
+template <int Arity, typename Key>
+inline bool LazyPQueue<Arity, Key>::queue(int vertex, Key distance)
+{
+	if (this->Queued[vertex])
+	{
+		if (distance == this->Latest[vertex])  // nothing changes:
+			return false;
+	}
+	else
+	{
+		this->Queued[vertex] = 1;
+		this->NumLive++;
+	}
+
+	this->Latest[vertex] = distance;
+
+	this->Keys.push_back(distance);
+	this->Vertices.push_back(vertex);
+
+	return true;
+}
+
+
+//
+// dropStale:
+//
+// Removes stale entries from the front until a live one is there; the
+// queue must not be empty.
+//
+template <int Arity, typename Key>
+inline void LazyPQueue<Arity, Key>::dropStale()
+{
+	while (true)
+	{
+		int v = this->Vertices[0];
+
+		if (this->Queued[v] && this->Keys[0] == this->Latest[v])  // live entry:
+			return;
+
+		this->removeTop();
+	}
+}
+
+
+//
+// removeTop:
+//
+// Removes the front entry, moving the last entry into its place.
+//
+template <int Arity, typename Key>
+void LazyPQueue<Arity, Key>::removeTop()
+{
+	int last = (int)this->Keys.size() - 1;
+
+	this->Keys[0] = this->Keys[last];
+	this->Vertices[0] = this->Vertices[last];
+
+	this->Keys.pop_back();
+	this->Vertices.pop_back();
+
+	if (last > 0)
+		this->shiftDown(0);
+}
+
+
+//
+// hole-based sift kernels, as in PQueue but without Positions:
+//
+template <int Arity, typename Key>
+inline void LazyPQueue<Arity, Key>::shiftUp(int position)
+{
+	Key movingKey = this->Keys[position];
+	int movingVertex = this->Vertices[position];
+
+	while (position > 0)
+	{
+		int parentIndex = (position - 1) / Arity;
+
+		if (!(movingKey < this->Keys[parentIndex]))
+			break;
+
+		this->Keys[position] = this->Keys[parentIndex];
+		this->Vertices[position] = this->Vertices[parentIndex];
+
+		position = parentIndex;
+	}
+
+	this->Keys[position] = movingKey;
+	this->Vertices[position] = movingVertex;
+}
+
+
+template <int Arity, typename Key>
+inline void LazyPQueue<Arity, Key>::shiftDown(int position)
+{
+	Key movingKey = this->Keys[position];
+	int movingVertex = this->Vertices[position];
+	int n = (int)this->Keys.size();
+
+	while (true)
+	{
+		int firstChildIndex = (position * Arity) + 1;
+
+		if (firstChildIndex >= n)  // leaf:
+			break;
+
+		int lastChildIndex = firstChildIndex + Arity;
+		if (lastChildIndex > n)
+			lastChildIndex = n;
+
+		int minIndex = firstChildIndex;
+
+		for (int c = firstChildIndex + 1; c < lastChildIndex; ++c)
+		{
+			if (this->Keys[c] < this->Keys[minIndex])
+				minIndex = c;
+		}
+
+		if (!(this->Keys[minIndex] < movingKey))
+			break;
+
+		this->Keys[position] = this->Keys[minIndex];
+		this->Vertices[position] = this->Vertices[minIndex];
+
+		position = minIndex;
+	}
+
+	this->Keys[position] = movingKey;
+	this->Vertices[position] = movingVertex;
+}
@@ -13,8 +13,25 @@
 #include <set>
 #include <algorithm>
 #include <limits>
+#include <iomanip>
 
 #include "pqueue.h"
+#include "lazypqueue.h"
+#include "radixheap.h"
+#include "pairingheap.h"
+#include "fixedpqueue.h"
+#include "bench.h"
+#include "microbench.h"
+#include "graph.h"
+#include "graphfile.h"
+#include "trace.h"
+#include "dijkstra.h"
+#include "bidijkstra.h"
+#include "astar.h"
+#include "deltastepping.h"
+#include "paralleldijkstra.h"
+#include "vertexorder.h"
+#include "streamformat.h"
 
 using namespace std;
 
@@ -28,7 +45,8 @@ using namespace std;
 // reveal inefficient solutions.  This test just pushes and
 // then pops them all.
 //
-int StressTest1(PQueue& pq, int N)
+template <typename Queue>
+int StressTest1(Queue& pq, int N)
 {
 	int distance = N;
 	int ops = 0;
@@ -98,7 +116,8 @@ int StressTest1(PQueue& pq, int N)
 //
 // A more random mixture of pushes and pops:
 //
-int StressTest2(PQueue& pq, int N)
+template <typename Queue>
+int StressTest2(Queue& pq, int N)
 {
 	int ops = 0;
 
@@ -192,35 +211,231 @@ int StressTest2(PQueue& pq, int N)
 
 
 
-//#define VS
+//
+// PrintShortestPaths:
+//
+// Outputs the result of a Dijkstra run: distance and predecessor of
+// every vertex, or of the first and last 3 vertices for large graphs.
+// The engine ran on a graph renumbered by order; the output is in the
+// original ids.
+//
+template <typename Engine>
+void PrintShortestPaths(const Engine& engine, int source, int N, const VertexOrder& order)
+{
+	cout << ">>Dijkstra from " << source << ": settled " << engine.Settled() << " vertices" << endl;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	for (int v = 0; v < N; ++v)
+	{
+		if (N >= 100 && v == 3)  // summarize large graphs:
+		{
+			cout << "  ..." << endl;
+			v = N - 3;
+		}
 
+		cout << "  " << v << ": ";
 
-int main()
+		int u = order.ToNew(v);
+
+		if (engine.Reached(u))
+			cout << engine.DistanceTo(u) << " (pred " << order.ToOriginal(engine.PredecessorOf(u)) << ")" << endl;
+		else
+			cout << "unreachable" << endl;
+	}
+}
+
+
+
+//
+// PrintSettled:
+//
+// Outputs the result of a bounded Dijkstra query: the vertices found,
+// nearest first, with distance and predecessor (the first and last 3
+// if there are many), in the original ids.
+//
+template <typename Engine>
+void PrintSettled(const Engine& engine, int source, const vector<int>& found, const VertexOrder& order)
 {
-	cout << "**Starting Test**" << endl;
+	cout << ">>Dijkstra from " << source << ": settled " << engine.Settled() << " vertices, found "
+		<< found.size() << endl;
 
-#ifdef VS
-	ifstream  file("values-6.txt");
-	if (!file.good())
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	for (size_t i = 0; i < found.size(); ++i)
 	{
-		cout << "**Unable to open input file?!" << endl;
-		return -1;
+		if (found.size() >= 100 && i == 3)  // summarize long lists:
+		{
+			cout << "  ..." << endl;
+			i = found.size() - 3;
+		}
+
+		int v = found[i];
+
+		cout << "  " << order.ToOriginal(v) << ": " << engine.DistanceTo(v) << " (pred "
+			<< order.ToOriginal(engine.PredecessorOf(v)) << ")" << endl;
 	}
-	istream&  input = file;
-#else
-	istream&   input = cin;
-#endif
+}
+
+
+
+//
+// PrintRoute:
+//
+// Outputs the result of a point-to-point query: distance, vertices
+// settled, and the path itself (summarized if it is long), in the
+// original ids.
+//
+template <typename Engine>
+void PrintRoute(const Engine& engine, int source, int target, const VertexOrder& order)
+{
+	cout << ">>Route from " << source << " to " << target << ": settled " << engine.Settled() << " vertices" << endl;
+
+	if (!engine.Reached())
+	{
+		cout << "  unreachable" << endl;
+		return;
+	}
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	vector<int> path = engine.Path();
+
+	cout << "  distance " << engine.DistanceBetween() << ", " << path.size() << " vertices:";
+
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		if (path.size() > 20 && i == 10)  // summarize long paths:
+		{
+			cout << " ...";
+			i = path.size() - 10;
+		}
+
+		cout << " " << order.ToOriginal(path[i]);
+	}
+
+	cout << endl;
+}
+
+
+
+//
+// PrintStats:
+//
+// Outputs the operation counters of a PQueue (see pqstats.h); the other
+// queues keep none.
+//
+template <typename Queue>
+void PrintStats(const Queue&)
+{
+	cout << ">>Stats: not kept by this queue" << endl;
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PrintStats(const PQueue<Arity, Key, Allocator, Index>& pq)
+{
+	if (!PQUEUE_STATS_ENABLED)
+	{
+		cout << ">>Stats: not compiled in, build with PQUEUE_STATS" << endl;
+		return;
+	}
+
+	cout << ">>Stats:" << endl;
+	pq.Stats().Print(cout);
+}
+
+
+
+//
+// SaveSnapshot / LoadSnapshot:
+//
+// Writes / reads a PQueue snapshot (see pqsnapshot.h); the other queues
+// do not support them.
+//
+template <typename Queue>
+void SaveSnapshot(Queue&, const string&)
+{
+	cout << "**Error: snapshots are only supported by the indexed and sparse queues" << endl;
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+void SaveSnapshot(PQueue<Arity, Key, Allocator, Index>& pq, const string& path)
+{
+	pq.SaveSnapshot(path);
+	cout << ">>Saved snapshot to '" << path << "'" << endl;
+}
 
-	//
-	// first we input the size of the queue / problem:
-	//
-	int     N;
-	input >> N;
 
-	PQueue  pq(N);
+template <typename Queue>
+void LoadSnapshot(Queue&, const string&)
+{
+	cout << "**Error: snapshots are only supported by the indexed and sparse queues" << endl;
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+void LoadSnapshot(PQueue<Arity, Key, Allocator, Index>& pq, const string& path)
+{
+	pq.LoadSnapshot(path);
+	pq.Dump("Restored:");
+}
+
+
+
+//
+// FillLazy:
+//
+// Fills a PQueue in O(1), its vertices queued implicitly (see
+// PQueue::FillLazy); the other queues only have Fill.
+//
+template <typename Queue>
+void FillLazy(Queue& pq, typename Queue::KeyType distance)
+{
+	cout << ">>lazy fill is only supported by the indexed and sparse queues, filling" << endl;
+	pq.Fill(distance);
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+void FillLazy(PQueue<Arity, Key, Allocator, Index>& pq, typename PQueue<Arity, Key, Allocator, Index>::KeyType distance)
+{
+	pq.FillLazy(distance);
+}
+
+
+
+//
+// RunCommands:
+//
+// Executes the queue / graph commands read from input, up to "exit",
+// against a queue of type Queue with capacity N.
+//
+template <typename Queue>
+void RunCommands(istream& input, int N)
+{
+	typedef typename Queue::KeyType Distance;
+
+	Queue   pq(N);
 	int     vertex;
 	int     distance;
 
+	bool    quiet = false;  // no output for push / pop / top / empty:
+
+	CSRGraph<Distance> graph;  // input via "graph" command:
+	vector<double>     X, Y;   // vertex coordinates, input via "coords" command:
+	VertexOrder        order;  // renumbering of graph (and X, Y), via "reorder" command:
+
 	//
 	// now start executing commands:
 	//
@@ -234,33 +449,129 @@ int main()
 			input >> vertex;
 			input >> distance;
 
-			pq.Push(vertex, distance);
+			try
+			{
+#ifdef PQUEUE_UNCHECKED
+				// the queue does not check its arguments in this build:
+				if (vertex < 0 || vertex >= N)
+					throw logic_error("Invalid vertex passed to Push, must be 0..N-1");
+#endif
+
+				pq.Push(vertex, distance);
 
-			cout << "Push: (" << vertex << "," << distance << ")" << endl;
+				if (!quiet)
+					cout << "Push: (" << vertex << "," << distance << ")" << '\n';
+			}
+			catch (logic_error& le)
+			{
+				cout << "Push: " << le.what() << '\n';
+			}
 		}
 		else if (cmd == "pop")
 		{
-			cout << "PopMin: ";
-
 			try
 			{
+#ifdef PQUEUE_UNCHECKED
+				if (pq.Empty())
+					throw logic_error("stack empty!");
+#endif
+
 				int v = pq.PopMin();
-				cout << "vertex " << v;
+
+				if (!quiet)
+					cout << "PopMin: vertex " << v << '\n';
 			}
 			catch (logic_error& le)
 			{
-				cout << le.what();
+				cout << "PopMin: " << le.what() << '\n';
 			}
 			catch (...)
 			{
-				cout << "unknown exception...";
+				cout << "PopMin: unknown exception..." << '\n';
 			}
+		}
+		else if (cmd == "top")
+		{
+			try
+			{
+#ifdef PQUEUE_UNCHECKED
+				if (pq.Empty())
+					throw logic_error("stack empty!");
+#endif
 
-			cout << endl;
+				int      v = pq.Top();
+				Distance d = pq.TopDistance();
+
+				if (!quiet)
+					cout << "Top: (" << v << "," << d << ")" << '\n';
+			}
+			catch (logic_error& le)
+			{
+				cout << "Top: " << le.what() << '\n';
+			}
 		}
 		else if (cmd == "empty")
 		{
-			cout << "Empty: " << pq.Empty() << endl;
+			bool empty = pq.Empty();
+
+			if (!quiet)
+				cout << "Empty: " << empty << '\n';
+		}
+		else if (cmd == "quiet")
+		{
+			//
+			// quiet on|off: push / pop / top / empty print nothing but errors:
+			//
+			string setting;
+			input >> setting;
+
+			quiet = (setting == "on");
+			cout << ">>quiet " << (quiet ? "on" : "off") << endl;
+		}
+		else if (cmd == "record")
+		{
+			//
+			// record path, followed by queue ops up to "end":
+			//
+			string path;
+			input >> path;
+
+			try
+			{
+				size_t n = RecordTrace(input, path);
+				cout << ">>recorded " << n << " ops: " << path << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "replay")
+		{
+			//
+			// replay path quiet|verbose: run a recorded trace against the queue:
+			//
+			string path, mode;
+			input >> path;
+			input >> mode;
+
+			try
+			{
+				TraceFile trace(path);
+
+				TraceResult result = ReplayTrace(pq, trace.Data(), trace.Size(), mode == "verbose" ? &cout : nullptr);
+
+				StreamFormat format(cout);
+
+				cout << std::fixed << std::setprecision(2);
+				cout << ">>replayed " << result.Ops << " ops in " << 1000.0 * result.Seconds << " ms ("
+					<< (result.Seconds > 0.0 ? result.Ops / result.Seconds / 1.0e6 : 0.0) << " Mops/sec), "
+					<< result.Pops << " pops, " << result.Errors << " errors, checksum " << result.Checksum << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
 		}
 		else if (cmd == "dump")
 		{
@@ -268,6 +579,30 @@ int main()
 			input >> step;
 			pq.Dump("Step " + step);
 		}
+		else if (cmd == "snapshot" || cmd == "restore")
+		{
+			//
+			// snapshot path: save the queue; restore path: replace it by a saved one:
+			//
+			string path;
+			input >> path;
+
+			try
+			{
+				if (cmd == "snapshot")
+					SaveSnapshot(pq, path);
+				else
+					LoadSnapshot(pq, path);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "stats")
+		{
+			PrintStats(pq);
+		}
 		else if (cmd == "fill")
 		{
 			int distance;
@@ -278,6 +613,23 @@ int main()
 			pq.Fill(distance);
 			pq.Dump("Filled:");
 		}
+		else if (cmd == "lazyfill")
+		{
+			int distance;
+			input >> distance;
+
+			cout << ">> filling lazily..." << endl;
+
+			FillLazy(pq, distance);
+			pq.Dump("Filled:");
+		}
+		else if (cmd == "reset")
+		{
+			cout << ">> resetting..." << endl;
+
+			pq.Reset();
+			pq.Dump("Reset:");
+		}
 		else if (cmd == "stress")
 		{
 			int result;
@@ -286,13 +638,39 @@ int main()
 
 			cout << ">> stressing..." << endl;
 
-			if (version == 1)
-				result = StressTest1(pq, N);
-			else if (version == 2)
-				result = StressTest2(pq, N);
-			else
+			try
+			{
+				if (version == 1)
+					result = StressTest1(pq, N);
+				else if (version == 2)
+					result = StressTest2(pq, N);
+				else if (version == 3)
+					result = BenchmarkArities(N);
+				else if (version == 4)
+					result = BenchmarkLazy(N);
+				else if (version == 5)
+					result = BenchmarkPairing(N);
+				else if (version == 6)
+					result = BenchmarkExecutor(N);
+				else if (version == 7)
+					result = BenchmarkDelta(N);
+				else if (version == 8)
+					result = BenchmarkSSSP(N);
+				else if (version == 9)
+					result = BenchmarkMultiQueue(N);
+				else if (version == 10)
+					result = BenchmarkFixed(N);
+				else if (version == 11)
+					result = BenchmarkReorder(N);
+				else
+				{
+					cout << "**Error: unknown stress test version (" << version << "), no test run" << endl;
+					result = -1;
+				}
+			}
+			catch (logic_error& le)  // e.g. a non-monotone push into the radix heap:
 			{
-				cout << "**Error: unknown stress test version (" << version << "), no test run" << endl;
+				cout << "**Error: " << le.what() << endl;
 				result = -1;
 			}
 
@@ -304,6 +682,334 @@ int main()
 			else
 				cout << ">>stress test #" << version << " was *not* successful :-(" << endl;
 		}
+		else if (cmd == "bench")
+		{
+			//
+			// bench maxN repetitions: time each queue operation, N = 1e3..maxN:
+			//
+			int maxN, repetitions;
+			input >> maxN;
+			input >> repetitions;
+
+			cout << ">> benchmarking..." << endl;
+
+			try
+			{
+				int result = MicroBenchmarks<Queue>(maxN, repetitions);
+
+				if (result > -1)
+					cout << ">>benchmarks were successful! [timed " << result << " ops]" << endl;
+				else
+					cout << ">>benchmarks were *not* successful :-(" << endl;
+			}
+			catch (logic_error& le)  // e.g. N beyond a fixed capacity:
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "graph")
+		{
+			//
+			// graph N M, followed by M edges "from to weight":
+			//
+			int  numVertices, numEdges;
+			input >> numVertices;
+			input >> numEdges;
+
+			vector<GraphEdge<Distance>> edges(numEdges);
+
+			for (GraphEdge<Distance>& e : edges)
+			{
+				input >> e.From;
+				input >> e.To;
+				input >> e.Weight;
+			}
+
+			try
+			{
+				graph = CSRGraph<Distance>::FromEdges(numVertices, edges);
+				X.clear();  // coordinates and order were for the old graph:
+				Y.clear();
+				order = VertexOrder();
+				cout << ">>graph: " << graph.NumVertices() << " vertices, " << graph.NumEdges() << " edges" << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "save")
+		{
+			string path;
+			input >> path;
+
+			try
+			{
+				if (order.Identity())
+					SaveGraph(graph, path);
+				else  // in the original ids, the order is not part of the file:
+					SaveGraph(graph.Permuted(order.OldIdArray()), path);
+
+				cout << ">>saved: " << path << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "load")
+		{
+			//
+			// maps a graph file written by "save", the arrays are used in place:
+			//
+			string path;
+			input >> path;
+
+			try
+			{
+				graph = MapGraph<Distance>(path);
+				X.clear();
+				Y.clear();
+				order = VertexOrder();
+				cout << ">>graph: " << graph.NumVertices() << " vertices, " << graph.NumEdges() << " edges" << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "reorder")
+		{
+			//
+			// reorder rcm | hilbert | none: renumber the graph for locality
+			// (hilbert needs coords), or back to the input order; vertices
+			// are still input and output in the original ids:
+			//
+			string method;
+			input >> method;
+
+			try
+			{
+				VertexOrder step;
+
+				if (method == "rcm")
+					step = CuthillMcKeeOrder(graph);
+				else if (method == "hilbert")
+				{
+					if (X.empty())
+						throw logic_error("reorder hilbert: no coords for the graph");
+
+					step = HilbertOrder(X, Y);
+				}
+				else if (method == "none")
+					step = order.Identity() ? VertexOrder() : VertexOrder(order.NewIdArray());
+				else
+					throw logic_error("reorder: unknown method '" + method + "', expecting rcm, hilbert or none");
+
+				double before = MeanEdgeSpan(graph);
+
+				if (!step.Identity())
+				{
+					graph = graph.Permuted(step.NewIdArray());
+
+					if (!X.empty())
+					{
+						vector<double> newX(X.size()), newY(Y.size());
+
+						for (int v = 0; v < (int)X.size(); ++v)
+						{
+							newX[step.ToNew(v)] = X[v];
+							newY[step.ToNew(v)] = Y[v];
+						}
+
+						X.swap(newX);
+						Y.swap(newY);
+					}
+				}
+
+				order = (method == "none") ? VertexOrder() : order.Then(step);
+
+				StreamFormat format(cout);
+
+				cout << std::fixed << std::setprecision(2);
+				cout << ">>reordered (" << method << "): mean edge span " << before << " -> " << MeanEdgeSpan(graph) << endl;
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "dijkstra")
+		{
+			int source;
+			input >> source;
+
+			try
+			{
+				Dijkstra<Queue> engine(graph);
+
+				engine.Run(order.ToNew(source));
+				PrintShortestPaths(engine, source, graph.NumVertices(), order);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "within" || cmd == "nearest")
+		{
+			//
+			// within source radius: the vertices within the radius;
+			// nearest source k n t1 .. tn: the k nearest of the n targets:
+			//
+			int source;
+			input >> source;
+
+			Distance         radius = 0;
+			size_t           k = 0;
+			vector<int>      targets;
+
+			if (cmd == "within")
+				input >> radius;
+			else
+			{
+				int n;
+				input >> k >> n;
+
+				targets.resize(max(n, 0));
+				for (int& t : targets)
+				{
+					input >> t;
+					t = order.ToNew(t);
+				}
+			}
+
+			try
+			{
+				Dijkstra<Queue> engine(graph);
+
+				if (cmd == "within")
+					engine.RunWithin(order.ToNew(source), radius);
+				else
+					engine.RunToTargets(order.ToNew(source), targets, k);
+
+				PrintSettled(engine, source, cmd == "within" ? engine.SettledVertices() : engine.SettledTargets(), order);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "delta")
+		{
+			//
+			// delta-stepping on all hardware threads, same output as dijkstra:
+			//
+			int source;
+			input >> source;
+
+			try
+			{
+				DeltaStepping<Distance> engine(graph);
+
+				engine.Run(order.ToNew(source));
+				PrintShortestPaths(engine, source, graph.NumVertices(), order);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "multiqueue")
+		{
+			//
+			// Dijkstra on a MultiQueue on all hardware threads, same output as dijkstra:
+			//
+			int source;
+			input >> source;
+
+			try
+			{
+				ParallelDijkstra<Distance> engine(graph);
+
+				engine.Run(order.ToNew(source));
+				PrintShortestPaths(engine, source, graph.NumVertices(), order);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "coords")
+		{
+			//
+			// coords, followed by "x y" for each vertex of the graph (in the
+			// original ids, stored by the graph's):
+			//
+			int N = graph.NumVertices();
+
+			X.resize(N);
+			Y.resize(N);
+
+			for (int v = 0; v < N; ++v)
+			{
+				input >> X[order.ToNew(v)];
+				input >> Y[order.ToNew(v)];
+			}
+
+			cout << ">>coords: " << N << " vertices" << endl;
+		}
+		else if (cmd == "astar")
+		{
+			//
+			// guided by straight-line distances if coordinates were given,
+			// otherwise the same as Dijkstra stopping at the target:
+			//
+			int source, target;
+			input >> source;
+			input >> target;
+
+			try
+			{
+				if (!X.empty() && target >= 0 && target < graph.NumVertices())
+				{
+					AStar<Queue, EuclideanHeuristic<Distance>> engine(graph);
+					int                                        goal = order.ToNew(target);
+
+					engine.Query(order.ToNew(source), goal, EuclideanHeuristic<Distance>(X.data(), Y.data(), goal));
+					PrintRoute(engine, source, target, order);
+				}
+				else
+				{
+					AStar<Queue> engine(graph);
+
+					engine.Query(order.ToNew(source), order.ToNew(target));
+					PrintRoute(engine, source, target, order);
+				}
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
+		else if (cmd == "route")
+		{
+			int source, target;
+			input >> source;
+			input >> target;
+
+			try
+			{
+				BidirectionalDijkstra<Queue> engine(graph);
+
+				engine.Query(order.ToNew(source), order.ToNew(target));
+				PrintRoute(engine, source, target, order);
+			}
+			catch (logic_error& le)
+			{
+				cout << "**Error: " << le.what() << endl;
+			}
+		}
 		else
 		{
 			cout << "**invalid cmd..." << endl;
@@ -311,6 +1017,74 @@ int main()
 
 		input >> cmd;
 	}
+}
+
+
+
+//#define VS
+
+
+int main(int argc, char* argv[])
+{
+	//
+	// cout is only flushed by endl, when its buffer fills, and at exit;
+	// by default reading cin would flush it before every command:
+	//
+	ios::sync_with_stdio(false);
+	cin.tie(nullptr);
+
+	cout << "**Starting Test**" << endl;
+
+#ifdef VS
+	ifstream  file("values-6.txt");
+	if (!file.good())
+	{
+		cout << "**Unable to open input file?!" << endl;
+		return -1;
+	}
+	istream&  input = file;
+#else
+	istream&   input = cin;
+#endif
+
+	//
+	// the queue implementation can be chosen on the command line:
+	//
+	string  mode = (argc > 1) ? argv[1] : "indexed";
+
+	if (mode != "indexed" && mode != "sparse" && mode != "lazy" && mode != "radix"
+		&& mode != "pairing" && mode != "fixed")
+	{
+		cout << "**Unknown queue mode '" << mode << "', expecting indexed, sparse, lazy, radix, pairing or fixed" << endl;
+		return -1;
+	}
+
+	//
+	// first we input the size of the queue / problem:
+	//
+	int     N;
+	input >> N;
+
+	if (mode == "sparse")  // hash table of positions:
+		RunCommands<SparsePQueue<2, double, int>>(input, N);
+	else if (mode == "lazy")
+		RunCommands<LazyPQueue<>>(input, N);
+	else if (mode == "radix")  // integer distances, checked for monotone pushes:
+		RunCommands<RadixHeap<uint32_t, true>>(input, N);
+	else if (mode == "pairing")
+		RunCommands<PairingHeap<>>(input, N);
+	else if (mode == "fixed")  // inline arrays, at most 256 vertices:
+	{
+		if (N < 0 || N > FixedPQueue<256>::MaxVertices)
+		{
+			cout << "**Error: the fixed queue holds at most " << FixedPQueue<256>::MaxVertices << " vertices" << endl;
+			return -1;
+		}
+
+		RunCommands<FixedPQueue<256>>(input, N);
+	}
+	else
+		RunCommands<PQueue<>>(input, N);
 
 	cout << "**Done**" << endl;
 	return 0;
@@ -0,0 +1,163 @@
+/*mappedfile.cpp*/
+
+//
+//   Platform specific file mapping for mappedfile.h: mmap on POSIX
+// systems, CreateFileMapping on Windows.
+//
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "mappedfile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define MAPPEDFILE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+//
+// Constructor:
+//
+// Maps the whole file at path, read-only.  An empty file maps to an
+// empty range.  Throws a logic_error if the file cannot be opened or
+// mapped.
+//
+MappedFile::MappedFile(const string& path)
+{
+	this->Base = nullptr;
+	this->Length = 0;
+	this->Mapped = false;
+
+#if defined(_WIN32)
+	this->FileHandle = INVALID_HANDLE_VALUE;
+	this->MappingHandle = nullptr;
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		throw logic_error("MappedFile: unable to open '" + path + "'");
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		throw logic_error("MappedFile: unable to get the size of '" + path + "'");
+	}
+
+	this->FileHandle = file;
+	this->Length = (size_t)size.QuadPart;
+
+	if (this->Length == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		throw logic_error("MappedFile: unable to map '" + path + "'");
+	}
+
+	this->MappingHandle = mapping;
+	this->Base = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (this->Base == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw logic_error("MappedFile: unable to map '" + path + "'");
+	}
+
+	this->Mapped = true;
+#elif defined(MAPPEDFILE_POSIX)
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		throw logic_error("MappedFile: unable to open '" + path + "'");
+
+	struct stat info;
+
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw logic_error("MappedFile: unable to get the size of '" + path + "'");
+	}
+
+	this->Length = (size_t)info.st_size;
+
+	if (this->Length > 0)
+	{
+		void* memory = mmap(nullptr, this->Length, PROT_READ, MAP_SHARED, fd, 0);
+
+		if (memory == MAP_FAILED)
+		{
+			close(fd);
+			throw logic_error("MappedFile: unable to map '" + path + "'");
+		}
+
+		this->Base = (const char*)memory;
+		this->Mapped = true;
+	}
+
+	close(fd);  // the mapping keeps the file open:
+#else
+	FILE* file = fopen(path.c_str(), "rb");
+
+	if (file == nullptr)
+		throw logic_error("MappedFile: unable to open '" + path + "'");
+
+	fseek(file, 0, SEEK_END);
+	this->Length = (size_t)ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	//
+	// malloc'ed memory is aligned for any type, like a mapping:
+	//
+	char* buffer = (char*)malloc(this->Length == 0 ? 1 : this->Length);
+
+	if (buffer == nullptr || fread(buffer, 1, this->Length, file) != this->Length)
+	{
+		free(buffer);
+		fclose(file);
+		throw logic_error("MappedFile: unable to read '" + path + "'");
+	}
+
+	fclose(file);
+	this->Base = buffer;
+#endif
+}
+
+
+//
+// Destructor:
+//
+// Unmaps the file; pointers into it are no longer valid.
+//
+MappedFile::~MappedFile()
+{
+#if defined(_WIN32)
+	if (this->Mapped)
+	{
+		UnmapViewOfFile(this->Base);
+		CloseHandle(this->MappingHandle);
+	}
+
+	if (this->FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(this->FileHandle);
+#elif defined(MAPPEDFILE_POSIX)
+	if (this->Mapped)
+		munmap((void*)this->Base, this->Length);
+#else
+	free((void*)this->Base);
+#endif
+}
@@ -0,0 +1,51 @@
+/*mappedfile.h*/
+
+//
+//   A read-only memory mapping of a whole file.  The file's pages are
+// only read from disk when first touched, and processes mapping the
+// same file share one copy of it in the page cache.  If the platform
+// has no memory mapping the file is read into memory instead.
+//
+//   The binary formats mapped with it (graph files, queue traces and
+// queue snapshots) are written in the byte order of the host, and
+// record FILE_BYTE_ORDER_MARK in their header, so a file written on a
+// host of the other byte order is recognized (it reads as 0x04030201)
+// and rejected instead of misread.
+//
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+
+const uint32_t FILE_BYTE_ORDER_MARK = 0x01020304;
+
+
+class MappedFile
+{
+private:
+  const char  *Base;
+  size_t       Length;
+  bool         Mapped;   // false => Base was read into an allocated buffer
+
+#if defined(_WIN32)
+  void        *FileHandle;
+  void        *MappingHandle;
+#endif
+
+public:
+  MappedFile(const string& path);  // throws a logic_error if the file cannot be mapped:
+  ~MappedFile();
+
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  const char* Data() const { return this->Base; }
+  size_t      Size() const { return this->Length; }
+};
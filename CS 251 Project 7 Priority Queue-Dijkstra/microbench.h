@@ -0,0 +1,252 @@
+/*microbench.h*/
+
+//
+//   Microbenchmarks for the queue operations, run from the driver's
+// "bench" command against whichever queue the driver was started with.
+// Each operation is timed on its own -- Push, PopMin, DecreaseKey,
+// Fill (followed by popping every vertex) and a mixed "hold" workload
+// (pop the minimum, push it back further out) -- for every N from 1e3
+// up to a maximum, in steps of 10x, and for four key distributions:
+//
+//   monotone   -- vertex v gets key v;
+//   reversed   -- key N - v, every push sifts to the root (StressTest1);
+//   random     -- a random permutation of 1..N (StressTest2);
+//   duplicate  -- random keys from only 16 distinct values.
+//
+//   Every benchmark is warmed up once and then repeated, with its setup
+// (e.g. filling the queue before timing PopMin) outside the measured
+// region, and reports the mean ns/op, the coefficient of variation
+// over the repetitions, the fastest repetition, and hardware counters
+// per op where the OS provides them (see perfcounters.h).
+//
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#include "perfcounters.h"
+#include "streamformat.h"
+
+using namespace std;
+
+
+struct MicroResult
+{
+  double  MeanNs;      // per op, over all repetitions
+  double  CvPercent;   // standard deviation / mean of the repetitions
+  double  MinNs;       // per op, fastest repetition
+  double  Counters[PerfCounters::NUM_COUNTERS];  // per op, mean
+};
+
+
+//
+// runs setup() then the timed run() repetitions times, for ops ops each,
+// after one untimed warm-up run:
+//
+template <typename Setup, typename Run>
+MicroResult MicroMeasure(int repetitions, size_t ops, PerfCounters& counters, Setup setup, Run run)
+{
+	vector<double> times;
+	double         totals[PerfCounters::NUM_COUNTERS] = { 0 };
+
+	setup();  // warm up caches, and grow the queue to its working size:
+	run();
+
+	for (int r = 0; r < repetitions; ++r)
+	{
+		setup();
+
+		counters.Start();
+		auto start = chrono::steady_clock::now();
+
+		run();
+
+		auto stop = chrono::steady_clock::now();
+		counters.Stop();
+
+		times.push_back(chrono::duration<double, nano>(stop - start).count() / (double)ops);
+
+		for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c)
+			totals[c] += (double)counters.Value((PerfCounters::Counter)c) / (double)ops;
+	}
+
+	MicroResult result;
+
+	double sum = 0.0, squares = 0.0;
+	for (double t : times)
+		sum += t;
+
+	result.MeanNs = sum / times.size();
+
+	for (double t : times)
+		squares += (t - result.MeanNs) * (t - result.MeanNs);
+
+	result.CvPercent = (times.size() > 1 && result.MeanNs > 0.0)
+		? 100.0 * sqrt(squares / (times.size() - 1)) / result.MeanNs : 0.0;
+	result.MinNs = *min_element(times.begin(), times.end());
+
+	for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c)
+		result.Counters[c] = totals[c] / repetitions;
+
+	return result;
+}
+
+
+//
+// prints one row of the results table:
+//
+inline void MicroPrint(const string& op, const string& distribution, int N, const MicroResult& r,
+                       const PerfCounters& counters)
+{
+	cout << "   " << setw(13) << left << op << setw(11) << distribution << right
+		<< setw(10) << N
+		<< setw(10) << setprecision(1) << r.MeanNs
+		<< setw(7) << setprecision(1) << r.CvPercent
+		<< setw(10) << setprecision(1) << r.MinNs;
+
+	for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c)
+	{
+		if (counters.Available((PerfCounters::Counter)c))
+			cout << setw(10) << setprecision(2) << r.Counters[c];
+		else
+			cout << setw(10) << "-";
+	}
+
+	cout << '\n';
+}
+
+
+//
+// MicroBenchmarks:
+//
+// Runs the benchmarks against a Queue for N = 1e3, 1e4, ... up to maxN,
+// each repetitions times.  The pops are checked to come out in key
+// order after timing; returns the # of timed ops, or -1 if a check
+// failed.
+//
+template <typename Queue>
+int MicroBenchmarks(int maxN, int repetitions)
+{
+	typedef typename Queue::KeyType Key;
+
+	if (maxN < 1 || repetitions < 1)
+		return -1;
+
+	PerfCounters counters;
+	bool         success = true;
+	double       ops = 0.0;
+
+	StreamFormat format(cout);  // restored on return:
+
+	cout << std::fixed;
+	cout << "   " << repetitions << " repetitions" << (counters.Available() ? "" : ", hardware counters not available") << '\n';
+	cout << "   " << setw(13) << left << "op" << setw(11) << "keys" << right << setw(10) << "N"
+		<< setw(10) << "ns/op" << setw(7) << "cv%" << setw(10) << "min";
+
+	for (int c = 0; c < PerfCounters::NUM_COUNTERS; ++c)
+		cout << setw(10) << PerfCounters::Name((PerfCounters::Counter)c);
+
+	cout << endl;
+
+	const char* distributions[] = { "monotone", "reversed", "random", "duplicate" };
+
+	for (int64_t n = min(1000, maxN); n <= maxN; n *= 10)
+	{
+		int N = (int)n;
+
+		Queue pq(N);
+
+		mt19937 gen;
+		uniform_int_distribution<int> holdDis(1, N);
+
+		vector<int> increments(N), popped(N);
+		for (int i = 0; i < N; ++i)
+			increments[i] = holdDis(gen);
+
+		for (int d = 0; d < 4; ++d)
+		{
+			vector<Key> keys(N);
+
+			for (int v = 0; v < N; ++v)
+			{
+				if (d == 0)
+					keys[v] = (Key)v;
+				else if (d == 1)
+					keys[v] = (Key)(N - v);
+				else if (d == 2)
+					keys[v] = (Key)(v + 1);
+				else
+					keys[v] = (Key)(gen() % 16);
+			}
+
+			if (d == 2)
+				shuffle(keys.begin(), keys.end(), gen);
+
+			Key  high = (Key)(2 * (int64_t)N + 16);  // above every key:
+			auto reset = [&] { pq.Reset(); };
+			auto fill = [&] { pq.Reset(); for (int v = 0; v < N; ++v) pq.Push(v, keys[v]); };
+			auto popAll = [&] { for (int i = 0; i < N; ++i) popped[i] = pq.PopMin(); };
+
+			auto ascending = [&]
+			{
+				for (int i = 1; i < N; ++i)
+				{
+					if (keys[popped[i]] < keys[popped[i - 1]])
+						return false;
+				}
+				return true;
+			};
+
+			MicroResult r;
+
+			r = MicroMeasure(repetitions, N, counters, reset, [&] { for (int v = 0; v < N; ++v) pq.Push(v, keys[v]); });
+			MicroPrint("Push", distributions[d], N, r, counters);
+
+			r = MicroMeasure(repetitions, N, counters, fill, popAll);
+			MicroPrint("PopMin", distributions[d], N, r, counters);
+			success &= ascending();
+
+			r = MicroMeasure(repetitions, N, counters,
+				[&] { pq.Reset(); for (int v = 0; v < N; ++v) pq.Push(v, high); },
+				[&] { for (int v = 0; v < N; ++v) pq.DecreaseKey(v, keys[v]); });
+			MicroPrint("DecreaseKey", distributions[d], N, r, counters);
+			popAll();
+			success &= ascending();
+
+			if (d == 0)  // Fill does not depend on the keys:
+			{
+				r = MicroMeasure(repetitions, N, counters, reset, [&] { pq.Fill(high); popAll(); });
+				MicroPrint("Fill+pops", "-", N, r, counters);
+			}
+
+			r = MicroMeasure(repetitions, 2 * (size_t)N, counters, fill, [&]
+			{
+				for (int i = 0; i < N; ++i)
+				{
+					int v;
+					Key k;
+
+					pq.PopMin(v, k);
+					pq.Push(v, (Key)(k + increments[i]));
+				}
+			});
+			MicroPrint("Hold", distributions[d], N, r, counters);
+
+			cout.flush();
+
+			ops += (double)repetitions * N * (d == 0 ? 6 : 5);
+		}
+	}
+
+	if (!success)
+		return -1;
+
+	return (int)min(ops, 2.0e9);
+}
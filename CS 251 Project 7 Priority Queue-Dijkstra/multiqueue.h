@@ -0,0 +1,338 @@
+/*multiqueue.h*/
+
+//
+//   A concurrent, relaxed priority queue for parallel label-setting
+// (MultiQueue): c * T independent heaps for T threads, each protected
+// by its own try-lock.  A push goes to a random heap; a pop looks at
+// the tops of two random heaps and takes the better one, so a pop
+// returns one of the smallest elements with high probability, not
+// necessarily the smallest, and threads rarely contend for the same
+// heap.  A thread that finds a heap locked just picks another one, so
+// no thread ever waits for a lock.
+//
+//   Like PQueue, the queue holds (vertex, distance) pairs and a push
+// only lowers a vertex's distance, but a vertex's distance lives in a
+// per-vertex atomic (lowered with compare-and-swap) rather than in the
+// heap: the heaps hold plain entries, possibly several per vertex, and
+// an entry whose distance is above its vertex's current distance is
+// stale and skipped when popped.  (PQueue itself cannot be the inner
+// heap: its position index holds one entry per vertex, and one index
+// of N entries per heap would multiply the memory by c * T.)
+//
+//   The queue also counts the vertices popped and not yet processed, so
+// the threads know when a search is finished: Drained() is true once
+// nothing is queued and nobody is still relaxing edges, i.e. nothing
+// more can be pushed.
+//
+//   Every thread passes its worker number 0..T-1, which selects its own
+// random number generator, so the queue needs no shared state but the
+// heaps.
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+
+template <typename Key = double>
+class MultiQueue
+{
+public:
+  typedef Key KeyType;
+
+private:
+  struct Entry
+  {
+    Key  Distance;
+    int  Vertex;
+
+    // std heaps are max-heaps, so "less" means larger distance:
+    bool operator<(const Entry& other) const { return other.Distance < this->Distance; }
+  };
+
+  struct alignas(64) Heap
+  {
+    atomic<bool>   Locked;
+    atomic<Key>    Top;       // distance of the min entry, Infinity() if empty
+    vector<Entry>  Entries;   // binary min-heap
+
+    Heap() : Locked(false), Top(Infinity()) { }
+  };
+
+  struct alignas(64) Random  // one per worker, xorshift:
+  {
+    uint64_t  State;
+
+    uint32_t Next()
+    {
+      this->State ^= this->State << 13;
+      this->State ^= this->State >> 7;
+      this->State ^= this->State << 17;
+      return (uint32_t)(this->State >> 32);
+    }
+  };
+
+  unique_ptr<Heap[]>         Heaps;
+  int                        NumHeaps;
+  vector<Random>             Generators;
+
+  unique_ptr<atomic<Key>[]>  Dist;       // current distance of every vertex
+  int                        Capacity;
+
+  alignas(64) atomic<int64_t>  Pending;  // entries queued + vertices being processed
+
+  bool tryLock(int h)  { return !this->Heaps[h].Locked.exchange(true, memory_order_acquire); }
+  void unlock(int h)   { this->Heaps[h].Locked.store(false, memory_order_release); }
+
+  bool popFrom(int h, int& vertex, Key& distance);
+
+public:
+  MultiQueue(int N, int numThreads, int heapsPerThread = 2);
+
+  MultiQueue(const MultiQueue& other) = delete;
+  MultiQueue& operator=(const MultiQueue& other) = delete;
+
+  static Key Infinity();
+
+  void Reset();
+
+  bool Push(int worker, int vertex, Key distance);
+  bool TryPopMin(int worker, int& vertex, Key& distance);
+  void Processed();
+  bool Drained() const;
+
+  Key  DistanceOf(int vertex) const { return this->Dist[vertex].load(memory_order_relaxed); }
+
+  int  HeapCount() const  { return this->NumHeaps; }
+  int  Threads() const    { return (int)this->Generators.size(); }
+};
+
+
+//
+// Constructor:
+//
+// A queue for vertices 0..N-1, used by numThreads threads (workers
+// 0..numThreads-1), with heapsPerThread heaps per thread (the c of
+// c * T; 2 is the usual choice, more lowers contention but makes the
+// pops less exact).
+//
+template <typename Key>
+MultiQueue<Key>::MultiQueue(int N, int numThreads, int heapsPerThread)
+	: Dist(new atomic<Key>[N > 0 ? N : 1]), Capacity(N), Pending(0)
+{
+	if (N < 0 || numThreads < 1 || heapsPerThread < 1)
+		throw logic_error("MultiQueue: invalid # of vertices, threads or heaps per thread");
+
+	this->NumHeaps = numThreads * heapsPerThread;
+	this->Heaps.reset(new Heap[this->NumHeaps]);
+	this->Generators.resize(numThreads);
+
+	for (int w = 0; w < numThreads; ++w)
+		this->Generators[w].State = 0x9E3779B97F4A7C15ull * (uint64_t)(w + 1);
+
+	for (int v = 0; v < N; ++v)
+		this->Dist[v].store(Infinity(), memory_order_relaxed);
+}
+
+
+//
+// Infinity:
+//
+// Distance of a vertex that has not been pushed; the largest value of
+// Key when it has no infinity (integer distances).
+//
+template <typename Key>
+Key MultiQueue<Key>::Infinity()
+{
+	if (numeric_limits<Key>::has_infinity)
+		return numeric_limits<Key>::infinity();
+	else
+		return numeric_limits<Key>::max();
+}
+
+
+//
+// Reset:
+//
+// Empties the queue and sets every vertex's distance back to
+// Infinity(), in O(N); not safe while other threads use the queue.
+//
+template <typename Key>
+void MultiQueue<Key>::Reset()
+{
+	for (int h = 0; h < this->NumHeaps; ++h)
+	{
+		this->Heaps[h].Entries.clear();
+		this->Heaps[h].Top.store(Infinity(), memory_order_relaxed);
+	}
+
+	for (int v = 0; v < this->Capacity; ++v)
+		this->Dist[v].store(Infinity(), memory_order_relaxed);
+
+	this->Pending.store(0);
+}
+
+
+//
+// Push:
+//
+// Lowers the vertex's distance to distance, if that is smaller than its
+// current one, and then queues it in a random heap; returns true if it
+// did.  Safe to call from any worker concurrently.
+//
+template <typename Key>
+bool MultiQueue<Key>::Push(int worker, int vertex, Key distance)
+{
+	atomic<Key>& slot = this->Dist[vertex];
+	Key          current = slot.load(memory_order_relaxed);
+
+	do
+	{
+		if (!(distance < current))
+			return false;
+	} while (!slot.compare_exchange_weak(current, distance, memory_order_relaxed));
+
+	//
+	// counted before it is visible in a heap, so Drained() cannot see an
+	// empty queue while the entry is on its way:
+	//
+	this->Pending.fetch_add(1, memory_order_relaxed);
+
+	Random& random = this->Generators[worker];
+	int     h;
+
+	do
+	{
+		h = (int)(random.Next() % (uint32_t)this->NumHeaps);
+	} while (!this->tryLock(h));
+
+	Heap& heap = this->Heaps[h];
+
+	heap.Entries.push_back({ distance, vertex });
+	push_heap(heap.Entries.begin(), heap.Entries.end());
+	heap.Top.store(heap.Entries.front().Distance, memory_order_relaxed);
+
+	this->unlock(h);
+
+	return true;
+}
+
+
+//
+// TryPopMin:
+//
+// Pops the smaller top of two random heaps, skipping stale entries, and
+// returns true with the vertex and its distance; the caller relaxes its
+// edges and then calls Processed().  Returns false if every heap is
+// empty, which does not mean the search is over (another worker may be
+// about to push; see Drained()).
+//
+template <typename Key>
+bool MultiQueue<Key>::TryPopMin(int worker, int& vertex, Key& distance)
+{
+	Random& random = this->Generators[worker];
+
+	for (;;)
+	{
+		for (int attempt = 0; attempt < 2 * this->NumHeaps; ++attempt)
+		{
+			int a = (int)(random.Next() % (uint32_t)this->NumHeaps);
+			int b = (int)(random.Next() % (uint32_t)this->NumHeaps);
+
+			Key ka = this->Heaps[a].Top.load(memory_order_relaxed);
+			Key kb = this->Heaps[b].Top.load(memory_order_relaxed);
+
+			int h = (kb < ka) ? b : a;
+
+			if (this->Heaps[h].Top.load(memory_order_relaxed) != Infinity() && this->popFrom(h, vertex, distance))
+				return true;
+		}
+
+		//
+		// the random picks found nothing; check every heap before giving up:
+		//
+		bool empty = true;
+
+		for (int h = 0; h < this->NumHeaps && empty; ++h)
+			empty = (this->Heaps[h].Top.load(memory_order_relaxed) == Infinity());
+
+		if (empty)
+			return false;
+	}
+}
+
+
+//
+// Processed:
+//
+// Called once the edges of a vertex returned by TryPopMin have been
+// relaxed (its pushes done).
+//
+template <typename Key>
+void MultiQueue<Key>::Processed()
+{
+	this->Pending.fetch_sub(1, memory_order_release);
+}
+
+
+//
+// Drained:
+//
+// True if nothing is queued and no popped vertex is still being
+// processed, so no more pushes can come: the search is finished.
+//
+template <typename Key>
+bool MultiQueue<Key>::Drained() const
+{
+	return this->Pending.load(memory_order_acquire) == 0;
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// pops the min live entry of heap h, if it is not locked, dropping the
+// stale entries above it (each of which is done with); returns false
+// if the heap is locked or has no live entry:
+//
+template <typename Key>
+bool MultiQueue<Key>::popFrom(int h, int& vertex, Key& distance)
+{
+	if (!this->tryLock(h))
+		return false;
+
+	Heap& heap = this->Heaps[h];
+	bool  found = false;
+
+	while (!heap.Entries.empty() && !found)
+	{
+		Entry top = heap.Entries.front();
+
+		pop_heap(heap.Entries.begin(), heap.Entries.end());
+		heap.Entries.pop_back();
+
+		if (top.Distance == this->Dist[top.Vertex].load(memory_order_relaxed))
+		{
+			vertex = top.Vertex;
+			distance = top.Distance;
+			found = true;
+		}
+		else  // stale:
+			this->Pending.fetch_sub(1, memory_order_relaxed);
+	}
+
+	heap.Top.store(heap.Entries.empty() ? Infinity() : heap.Entries.front().Distance, memory_order_relaxed);
+
+	this->unlock(h);
+
+	return found;
+}
@@ -0,0 +1,509 @@
+/*pairingheap.h*/
+
+//
+//   A pairing heap with the same interface as PQueue.  The heap is a
+// tree in which every node's distance is no smaller than its parent's;
+// Push and DecreaseKey link a node with the root in O(1), and PopMin
+// removes the root and pairs up its children (two-pass pairing), which
+// is O(logN) amortized.  Since decrease-keys are O(1) amortized in
+// practice, this suits dense graphs, where relaxations improve queued
+// vertices far more often than vertices are popped.
+//
+//   The nodes are not allocated individually: they live in one array
+// indexed by vertex, each holding the distance and the tree links as
+// vertex numbers (first child, next sibling, and previous sibling or
+// parent), so a vertex's node is found without a Positions table and
+// a link step touches a single cache line.
+//
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#include "pqcheck.h"
+
+using namespace std;
+
+
+template <typename Key = double>
+class PairingHeap
+{
+private:
+  struct Node
+  {
+    Key       Distance;
+    int       Child;     // first child (-1 if none)
+    int       Sibling;   // next sibling (-1 if none)
+    int       Prev;      // previous sibling, or parent if first child (-1 for the root)
+    uint32_t  Stamp;     // vertex is queued iff Stamp == Epoch
+  };
+
+  vector<Node>      Nodes;     // node of vertex v is Nodes[v]
+  uint32_t          Epoch;
+
+  vector<int>       Pairs;     // scratch list for two-pass pairing
+
+  int   Root;          // -1 if empty
+  int   NumElements;   // # of elements currently in queue
+  int   Capacity;      // max # of vertices we can support
+
+  bool queued(int v) const { return this->Nodes[v].Stamp == this->Epoch; }
+
+  int  link(int a, int b);
+  void cut(int v);
+  int  combine(int first);
+  void insert(int vertex, Key distance);
+  void remove(int vertex);
+
+public:
+  typedef Key KeyType;
+
+  PairingHeap(int N);  // constructor:
+
+  void Fill(Key distance);
+  void Reset();
+
+  void Push(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  void DecreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  void IncreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT;
+  int  PopMin() PQUEUE_NOEXCEPT;
+  void PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT;
+  int  Top() PQUEUE_NOEXCEPT;
+  Key  TopDistance() PQUEUE_NOEXCEPT;
+  bool Empty() PQUEUE_NOEXCEPT;
+
+  void   PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT;
+  size_t PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT;
+
+  void Dump(string title);  // debugging output of contents:
+};
+
+
+//
+// Constructor:
+//
+// N is the capacity of the queue, vertices are numbered 0..N-1.
+//
+template <typename Key>
+PairingHeap<Key>::PairingHeap(int N)
+	: Nodes(N, Node{ Key(), -1, -1, -1, 0 })
+{
+	this->Epoch = 1;
+	this->Root = -1;
+	this->NumElements = 0;
+	this->Capacity = N;
+}
+
+
+//
+// Fill:
+//
+// Replaces the contents of the queue by all N vertices at the same
+// distance, in O(N): every vertex becomes a child of vertex 0.
+//
+template <typename Key>
+void PairingHeap<Key>::Fill(Key distance)
+{
+	this->Reset();
+
+	for (int v = 0; v < this->Capacity; ++v)
+		this->insert(v, distance);
+}
+
+
+//
+// Reset:
+//
+// Empties the queue in O(1) by starting a new epoch; the links of the
+// old nodes are rewritten when their vertices are pushed again.
+//
+template <typename Key>
+void PairingHeap<Key>::Reset()
+{
+	this->Epoch++;
+
+	if (this->Epoch == 0)  // wrapped around, old stamps could look current:
+	{
+		for (int v = 0; v < this->Capacity; ++v)
+			this->Nodes[v].Stamp = 0;
+
+		this->Epoch = 1;
+	}
+
+	this->Root = -1;
+	this->NumElements = 0;
+}
+
+
+//
+// Push:
+//
+// Inserts (vertex, distance), replacing the vertex's current distance
+// if it is already queued (via DecreaseKey or IncreaseKey).
+//
+template <typename Key>
+void PairingHeap<Key>::Push(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to PairingHeap::Push, must be 0..N-1");
+
+	if (this->queued(vertex))
+	{
+		if (distance < this->Nodes[vertex].Distance)
+			this->DecreaseKey(vertex, distance);
+		else if (distance > this->Nodes[vertex].Distance)
+			this->IncreaseKey(vertex, distance);
+
+		// else same distance, nothing to do:
+		return;
+	}
+
+	this->insert(vertex, distance);
+}
+
+
+//
+// DecreaseKey:
+//
+// Lowers the distance of a queued vertex: its subtree is cut from the
+// tree and linked with the root, O(1).  Throws a logic_error if the
+// vertex is not queued, or the distance is larger than the current one.
+//
+template <typename Key>
+void PairingHeap<Key>::DecreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to PairingHeap::DecreaseKey, must be 0..N-1");
+	PQUEUE_CHECK(this->queued(vertex),
+		"Vertex passed to PairingHeap::DecreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance > this->Nodes[vertex].Distance),
+		"Distance passed to PairingHeap::DecreaseKey is larger than current distance");
+
+	this->Nodes[vertex].Distance = distance;
+
+	if (vertex == this->Root)
+		return;
+
+	this->cut(vertex);
+	this->Root = this->link(this->Root, vertex);
+}
+
+
+//
+// IncreaseKey:
+//
+// Raises the distance of a queued vertex, by removing it and inserting
+// it again.  Throws a logic_error if the vertex is not queued, or the
+// distance is smaller than the current one.
+//
+template <typename Key>
+void PairingHeap<Key>::IncreaseKey(int vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to PairingHeap::IncreaseKey, must be 0..N-1");
+	PQUEUE_CHECK(this->queued(vertex),
+		"Vertex passed to PairingHeap::IncreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance < this->Nodes[vertex].Distance),
+		"Distance passed to PairingHeap::IncreaseKey is smaller than current distance");
+
+	this->remove(vertex);
+	this->insert(vertex, distance);
+}
+
+
+//
+// PopMin:
+//
+// Pops (and removes) the vertex with the smallest distance.  If the
+// queue is empty a logic_error "stack empty!" is thrown.
+//
+template <typename Key>
+int PairingHeap<Key>::PopMin() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	int v = this->Root;
+
+	this->remove(v);
+
+	return v;
+}
+
+
+//
+// PopMin(vertex, distance):
+//
+// Same as PopMin(), but also returns the popped vertex's distance.
+//
+template <typename Key>
+void PairingHeap<Key>::PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	vertex = this->Root;
+	distance = this->Nodes[vertex].Distance;
+
+	this->remove(vertex);
+}
+
+
+//
+// Top / TopDistance:
+//
+// The vertex PopMin would return next (the root), and its distance,
+// without removing it.  Throws a logic_error "stack empty!" if the
+// queue is empty.
+//
+template <typename Key>
+int PairingHeap<Key>::Top() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->Root;
+}
+
+
+template <typename Key>
+Key PairingHeap<Key>::TopDistance() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->Nodes[this->Root].Distance;
+}
+
+
+//
+// Empty:
+//
+// Returns true if the queue is empty, false if not.
+//
+template <typename Key>
+bool PairingHeap<Key>::Empty() PQUEUE_NOEXCEPT
+{
+	return (this->NumElements == 0);
+}
+
+
+//
+// PushBatch:
+//
+// Same as n calls to Push; pushes are O(1) already.
+//
+template <typename Key>
+void PairingHeap<Key>::PushBatch(const int* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT
+{
+	for (size_t i = 0; i < n; ++i)
+		this->Push(vertices[i], distances[i]);
+}
+
+
+//
+// PopMinBatch:
+//
+// Pops up to k vertices in ascending order of distance into out[], and
+// returns how many were popped (fewer than k if the queue runs empty).
+//
+template <typename Key>
+size_t PairingHeap<Key>::PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT
+{
+	size_t count = 0;
+
+	while (count < k && !this->Empty())
+	{
+		out[count] = this->PopMin();
+		count++;
+	}
+
+	return count;
+}
+
+
+//
+// Dump:
+//
+// Dumps the root and then the queued vertices (up to 100) level by
+// level to the console; this is for debugging purposes.
+//
+template <typename Key>
+void PairingHeap<Key>::Dump(string title)
+{
+	cout << ">>PairingHeap: " << title << endl;
+
+	cout << "  # elements: " << this->NumElements << endl;
+
+	if (this->Empty())  // no output:
+		return;
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	cout << "  ";
+
+	vector<int> level(1, this->Root);
+	int printed = 0;
+
+	for (size_t i = 0; i < level.size() && printed < 100; ++i)
+	{
+		int v = level[i];
+
+		cout << "(" << v << "," << this->Nodes[v].Distance << ") ";
+		printed++;
+
+		// collect only as many children as can still be printed:
+		for (int c = this->Nodes[v].Child; c != -1 && level.size() < 100; c = this->Nodes[c].Sibling)
+			level.push_back(c);
+	}
+
+	if (printed < this->NumElements)
+		cout << "...";
+
+	cout << endl;
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// links two roots, making the one with the larger distance the first
+// child of the other, and returns the new root (a on ties):
+//
+template <typename Key>
+inline int PairingHeap<Key>::link(int a, int b)
+{
+	if (this->Nodes[b].Distance < this->Nodes[a].Distance)
+	{
+		int t = a;
+		a = b;
+		b = t;
+	}
+
+	int first = this->Nodes[a].Child;
+
+	this->Nodes[b].Sibling = first;
+	if (first != -1)
+		this->Nodes[first].Prev = b;
+
+	this->Nodes[b].Prev = a;
+	this->Nodes[a].Child = b;
+
+	this->Nodes[a].Sibling = -1;
+	this->Nodes[a].Prev = -1;
+
+	return a;
+}
+
+
+//
+// detaches the subtree rooted at v (not the root) from its parent or
+// previous sibling:
+//
+template <typename Key>
+inline void PairingHeap<Key>::cut(int v)
+{
+	int prev = this->Nodes[v].Prev;
+	int next = this->Nodes[v].Sibling;
+
+	if (this->Nodes[prev].Child == v)  // v is the first child of prev:
+		this->Nodes[prev].Child = next;
+	else
+		this->Nodes[prev].Sibling = next;
+
+	if (next != -1)
+		this->Nodes[next].Prev = prev;
+
+	this->Nodes[v].Prev = -1;
+	this->Nodes[v].Sibling = -1;
+}
+
+
+//
+// two-pass pairing of the sibling list starting at first: link pairs
+// left to right, then link the results right to left into one tree,
+// whose root is returned (-1 for an empty list):
+//
+template <typename Key>
+int PairingHeap<Key>::combine(int first)
+{
+	if (first == -1)
+		return -1;
+
+	this->Pairs.clear();
+
+	int c = first;
+
+	while (c != -1)
+	{
+		int a = c;
+		int b = this->Nodes[a].Sibling;
+
+		if (b == -1)
+		{
+			this->Nodes[a].Prev = -1;
+			this->Pairs.push_back(a);
+			break;
+		}
+
+		c = this->Nodes[b].Sibling;
+
+		this->Pairs.push_back(this->link(a, b));
+	}
+
+	int root = this->Pairs.back();
+
+	for (int i = (int)this->Pairs.size() - 2; i >= 0; --i)
+		root = this->link(this->Pairs[i], root);
+
+	return root;
+}
+
+
+//
+// inserts a vertex that is not queued as a new single-node tree:
+//
+template <typename Key>
+inline void PairingHeap<Key>::insert(int vertex, Key distance)
+{
+	this->Nodes[vertex].Distance = distance;
+	this->Nodes[vertex].Child = -1;
+	this->Nodes[vertex].Sibling = -1;
+	this->Nodes[vertex].Prev = -1;
+	this->Nodes[vertex].Stamp = this->Epoch;
+
+	if (this->Root == -1)
+		this->Root = vertex;
+	else
+		this->Root = this->link(this->Root, vertex);
+
+	this->NumElements++;
+}
+
+
+//
+// removes a queued vertex: its children are paired into one tree, which
+// takes its place (for the root) or is linked with the root:
+//
+template <typename Key>
+void PairingHeap<Key>::remove(int vertex)
+{
+	int children = this->combine(this->Nodes[vertex].Child);
+	this->Nodes[vertex].Child = -1;
+
+	if (vertex == this->Root)
+		this->Root = children;
+	else
+	{
+		this->cut(vertex);
+
+		if (children != -1)
+			this->Root = this->link(this->Root, children);
+	}
+
+	this->Nodes[vertex].Stamp = 0;
+	this->NumElements--;
+}
@@ -0,0 +1,151 @@
+/*paralleldijkstra.h*/
+
+//
+//   Parallel single-source shortest paths over a CSRGraph, using
+// Dijkstra's algorithm on a MultiQueue: every worker repeatedly pops a
+// vertex near the front of the shared relaxed queue and relaxes its
+// edges, pushing the vertices it improves.  Since a pop need not return
+// the exact minimum, a vertex can be popped before its distance is
+// final; it is then pushed and processed again once it improves, so
+// the result is exact and the relaxation only costs some repeated work
+// (Settled() counts every processed pop).  The search ends when the
+// queue is drained.
+//
+//   It has the same constructor arguments (bar delta) and results
+// interface as DeltaStepping, and so as Dijkstra.  Like DeltaStepping,
+// the predecessors are derived from the final distances afterwards
+// (see shortestpathtree.h).
+//
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+#include "threadpool.h"
+#include "multiqueue.h"
+#include "shortestpathtree.h"
+
+using namespace std;
+
+
+template <typename W = double>
+class ParallelDijkstra
+{
+public:
+  typedef W Distance;
+
+private:
+  const CSRGraph<Distance>& Graph;
+  ThreadPool                Pool;
+  MultiQueue<Distance>      PQ;
+
+  unique_ptr<atomic<int>[]>  Parent;   // scratch for FindPredecessors
+
+  vector<Distance>  Dist;   // results of the last Run
+  vector<int>       Pred;
+
+  int   NumSettled;         // # of pops processed by the last Run (>= # reached)
+
+public:
+  ParallelDijkstra(const CSRGraph<Distance>& graph, int numThreads = 0, int heapsPerThread = 2);
+
+  void Run(int source);
+
+  static Distance Infinity() { return MultiQueue<Distance>::Infinity(); }
+
+  int       Threads() const  { return this->Pool.Size(); }
+
+  const vector<Distance>& Distances() const    { return this->Dist; }
+  const vector<int>&      Predecessors() const { return this->Pred; }
+
+  Distance  DistanceTo(int v) const     { return this->Dist[v]; }
+  int       PredecessorOf(int v) const  { return this->Pred[v]; }
+  bool      Reached(int v) const        { return this->Dist[v] != Infinity(); }
+  int       Settled() const             { return this->NumSettled; }
+};
+
+
+//
+// Constructor:
+//
+// Prepares an engine for the given graph, which must outlive the engine
+// and have non-negative edge weights (a logic_error is thrown if not),
+// with numThreads workers (0 => one per hardware thread) sharing a
+// MultiQueue of heapsPerThread heaps per worker.
+//
+template <typename W>
+ParallelDijkstra<W>::ParallelDijkstra(const CSRGraph<Distance>& graph, int numThreads, int heapsPerThread)
+	: Graph(graph), Pool(numThreads), PQ(graph.NumVertices(), Pool.Size(), heapsPerThread),
+	  Parent(new atomic<int>[graph.NumVertices() > 0 ? graph.NumVertices() : 1]),
+	  Dist(graph.NumVertices(), Infinity()), Pred(graph.NumVertices(), -1)
+{
+	if (!graph.NonNegativeWeights())
+		throw logic_error("ParallelDijkstra: graph has a negative edge weight");
+
+	this->NumSettled = 0;
+}
+
+
+//
+// Run:
+//
+// Computes shortest paths from source to every vertex, with the same
+// results as Dijkstra::Run.
+//
+template <typename W>
+void ParallelDijkstra<W>::Run(int source)
+{
+	int N = this->Graph.NumVertices();
+
+	if (source < 0 || source >= N)
+		throw logic_error("ParallelDijkstra::Run: invalid source vertex, must be 0..N-1");
+
+	this->PQ.Reset();
+	this->PQ.Push(0, source, Distance(0));
+
+	atomic<int> settled(0);
+
+	this->Pool.Run([&](int w)
+	{
+		const CSRGraph<Distance>& graph = this->Graph;
+
+		int count = 0;
+
+		while (!this->PQ.Drained())
+		{
+			int      u;
+			Distance du;
+
+			if (!this->PQ.TryPopMin(w, u, du))
+			{
+				this_thread::yield();  // others are still relaxing, and may push:
+				continue;
+			}
+
+			count++;
+
+			int64_t end = graph.EdgesEnd(u);
+
+			for (int64_t e = graph.EdgesBegin(u); e < end; ++e)
+				this->PQ.Push(w, graph.Target(e), du + graph.Weight(e));
+
+			this->PQ.Processed();
+		}
+
+		settled.fetch_add(count, memory_order_relaxed);
+	});
+
+	this->NumSettled = settled.load();
+
+	for (int v = 0; v < N; ++v)
+		this->Dist[v] = this->PQ.DistanceOf(v);
+
+	FindPredecessors(this->Graph, source, this->Dist.data(), Infinity(), this->Parent.get(), this->Pred.data(), this->Pool);
+}
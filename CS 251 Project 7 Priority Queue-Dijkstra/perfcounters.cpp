@@ -0,0 +1,127 @@
+/*perfcounters.cpp*/
+
+//
+//   Platform specific part of perfcounters.h: the Linux perf_event_open
+// interface.  Each counter is opened separately (not as a group), so a
+// CPU that lacks one of the events still provides the others.
+//
+
+#include <cstring>
+
+#include "perfcounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+PerfCounters::PerfCounters()
+{
+	this->Enabled = false;
+
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		this->Fds[c] = -1;
+		this->Values[c] = 0;
+	}
+
+#if defined(__linux__)
+	static const uint64_t configs[NUM_COUNTERS] =
+	{
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = configs[c];
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		this->Fds[c] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+		if (this->Fds[c] >= 0)
+			this->Enabled = true;
+	}
+#endif
+}
+
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		if (this->Fds[c] >= 0)
+			close(this->Fds[c]);
+	}
+#endif
+}
+
+
+//
+// Start:
+//
+// Resets and starts the counters.
+//
+void PerfCounters::Start()
+{
+#if defined(__linux__)
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		if (this->Fds[c] >= 0)
+		{
+			ioctl(this->Fds[c], PERF_EVENT_IOC_RESET, 0);
+			ioctl(this->Fds[c], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+
+//
+// Stop:
+//
+// Stops the counters and reads their counts since Start.
+//
+void PerfCounters::Stop()
+{
+#if defined(__linux__)
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		if (this->Fds[c] >= 0)
+			ioctl(this->Fds[c], PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	for (int c = 0; c < NUM_COUNTERS; ++c)
+	{
+		uint64_t value = 0;
+
+		if (this->Fds[c] >= 0 && read(this->Fds[c], &value, sizeof(value)) == (ssize_t)sizeof(value))
+			this->Values[c] = value;
+		else
+			this->Values[c] = 0;
+	}
+#endif
+}
+
+
+const char* PerfCounters::Name(Counter counter)
+{
+	static const char* names[NUM_COUNTERS] = { "cycles", "instr", "LLC-miss", "br-miss" };
+
+	return names[counter];
+}
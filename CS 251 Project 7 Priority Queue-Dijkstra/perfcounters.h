@@ -0,0 +1,52 @@
+/*perfcounters.h*/
+
+//
+//   Hardware performance counters around a measured region: CPU cycles,
+// instructions, last-level cache misses and branch misses, counted for
+// the calling thread in user mode.  On Linux they come from
+// perf_event_open; elsewhere, or where the kernel does not allow it
+// (e.g. in VMs and containers, or with perf_event_paranoid > 2),
+// Available() is false and every count reads 0.
+//
+
+#pragma once
+
+#include <cstdint>
+
+using namespace std;
+
+
+class PerfCounters
+{
+public:
+  enum Counter
+  {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    NUM_COUNTERS
+  };
+
+private:
+  int       Fds[NUM_COUNTERS];     // -1 if the counter could not be opened
+  uint64_t  Values[NUM_COUNTERS];  // counts of the last Start .. Stop
+  bool      Enabled;               // at least one counter is open
+
+public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters& other) = delete;
+  PerfCounters& operator=(const PerfCounters& other) = delete;
+
+  bool  Available() const                 { return this->Enabled; }
+  bool  Available(Counter counter) const  { return this->Fds[counter] >= 0; }
+
+  void  Start();
+  void  Stop();
+
+  uint64_t Value(Counter counter) const   { return this->Values[counter]; }
+
+  static const char* Name(Counter counter);
+};
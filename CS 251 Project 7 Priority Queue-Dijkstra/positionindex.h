@@ -0,0 +1,316 @@
+/*positionindex.h*/
+
+//
+//   Position indexes for PQueue: the map from a vertex to its position
+// in the heap, which PQueue updates on every sift step.
+//
+//   DenseIndex is an array with one slot per vertex 0..N-1, so lookups
+// are a single load, but its memory scales with the graph.
+//
+//   HashIndex is an open-addressing (linear probing) hash table keyed by
+// vertex id, which can be any integer type, e.g. sparse 64-bit ids.  It
+// starts small and doubles as vertices are touched, so its memory
+// scales with the part of the graph a query explores.
+//
+//   Both stamp their entries with an epoch, so Clear() is O(1).  Find
+// distinguishes vertices touched since the last Clear (position, or -1
+// if no longer queued) from untouched ones (UNTOUCHED), which PQueue
+// needs for its implicit Fill.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "allocator.h"
+
+using namespace std;
+
+
+template <typename Allocator = AlignedAllocator<int>>
+class DenseIndex
+{
+private:
+  struct Slot
+  {
+    int       Position;  // position in queue (-1 if not present)
+    uint32_t  Epoch;     // slot is only valid if this is the current epoch
+  };
+
+  Slot      *Slots;
+  int        Size;
+  uint32_t   Epoch;
+  Allocator  Alloc;
+
+public:
+  typedef int VertexType;
+
+  static const int UNTOUCHED = -3;
+
+  DenseIndex(int N, const Allocator& allocator = Allocator());
+  ~DenseIndex();
+
+  DenseIndex(const DenseIndex& other) = delete;
+  DenseIndex& operator=(const DenseIndex& other) = delete;
+
+  bool Valid(int v) const  { return v >= 0 && v < this->Size; }
+
+  int  Find(int v) const
+  {
+    const Slot& slot = this->Slots[v];
+    return (slot.Epoch == this->Epoch) ? slot.Position : UNTOUCHED;
+  }
+
+  void Set(int v, int position)
+  {
+    this->Slots[v].Position = position;
+    this->Slots[v].Epoch = this->Epoch;
+  }
+
+  // v must have been Set since the last Clear:
+  void Move(int v, int position)  { this->Slots[v].Position = position; }
+
+  void Clear();
+};
+
+
+template <typename Vertex = int64_t, typename Allocator = AlignedAllocator<int>>
+class HashIndex
+{
+private:
+  struct Entry
+  {
+    Vertex    Id;
+    int       Position;  // position in queue (-1 if not present)
+    uint32_t  Epoch;     // entry is only in use if this is the current epoch
+  };
+
+  Entry     *Table;
+  size_t     Mask;       // table size - 1, the size is a power of 2
+  size_t     Count;      // # of entries in use
+  uint32_t   Epoch;
+  Allocator  Alloc;
+
+  static const size_t INITIAL_SIZE = 16;
+
+  static size_t hash(Vertex v);
+  size_t probe(Vertex v) const;
+  void   grow();
+
+public:
+  typedef Vertex VertexType;
+
+  static const int UNTOUCHED = -3;
+
+  HashIndex(int N, const Allocator& allocator = Allocator());
+  ~HashIndex();
+
+  HashIndex(const HashIndex& other) = delete;
+  HashIndex& operator=(const HashIndex& other) = delete;
+
+  bool Valid(Vertex) const  { return true; }  // any id can be stored:
+
+  int  Find(Vertex v) const
+  {
+    const Entry& entry = this->Table[this->probe(v)];
+    return (entry.Epoch == this->Epoch) ? entry.Position : UNTOUCHED;
+  }
+
+  void Set(Vertex v, int position);
+
+  // v must have been Set since the last Clear:
+  void Move(Vertex v, int position)  { this->Table[this->probe(v)].Position = position; }
+
+  void Clear();
+
+  size_t Entries() const { return this->Count; }
+};
+
+
+//
+// DenseIndex constructor:
+//
+// One slot for each vertex 0..N-1, all untouched.
+//
+template <typename Allocator>
+DenseIndex<Allocator>::DenseIndex(int N, const Allocator& allocator)
+	: Alloc(allocator)
+{
+	this->Slots = AllocateArray<Slot>(this->Alloc, (size_t)N);
+	this->Size = N;
+	this->Epoch = 1;
+
+	for (int v = 0; v < N; ++v)
+	{
+		this->Slots[v].Position = -1;
+		this->Slots[v].Epoch = 0;
+	}
+}
+
+
+template <typename Allocator>
+DenseIndex<Allocator>::~DenseIndex()
+{
+	DeallocateArray(this->Alloc, this->Slots, (size_t)this->Size);
+}
+
+
+//
+// Clear:
+//
+// Makes every vertex untouched in O(1) by starting a new epoch.  After
+// 2^32 epochs the counter wraps around, and old stamps could look
+// current again, so then all stamps are cleared.
+//
+template <typename Allocator>
+void DenseIndex<Allocator>::Clear()
+{
+	this->Epoch++;
+
+	if (this->Epoch == 0)  // wrapped around:
+	{
+		for (int v = 0; v < this->Size; ++v)
+			this->Slots[v].Epoch = 0;
+
+		this->Epoch = 1;
+	}
+}
+
+
+//
+// HashIndex constructor:
+//
+// N is not needed, the table grows with the # of vertices touched.
+//
+template <typename Vertex, typename Allocator>
+HashIndex<Vertex, Allocator>::HashIndex(int, const Allocator& allocator)
+	: Alloc(allocator)
+{
+	this->Table = AllocateArray<Entry>(this->Alloc, INITIAL_SIZE);
+	this->Mask = INITIAL_SIZE - 1;
+	this->Count = 0;
+	this->Epoch = 1;
+
+	for (size_t i = 0; i < INITIAL_SIZE; ++i)
+		this->Table[i].Epoch = 0;
+}
+
+
+template <typename Vertex, typename Allocator>
+HashIndex<Vertex, Allocator>::~HashIndex()
+{
+	DeallocateArray(this->Alloc, this->Table, this->Mask + 1);
+}
+
+
+//
+// Set:
+//
+// Sets the position of a vertex, adding it to the table if it is not
+// there yet.  The table doubles when it would be more than 3/4 full.
+//
+template <typename Vertex, typename Allocator>
+void HashIndex<Vertex, Allocator>::Set(Vertex v, int position)
+{
+	size_t i = this->probe(v);
+
+	if (this->Table[i].Epoch != this->Epoch)  // new entry:
+	{
+		if ((this->Count + 1) * 4 > (this->Mask + 1) * 3)
+		{
+			this->grow();
+			i = this->probe(v);
+		}
+
+		this->Table[i].Id = v;
+		this->Table[i].Epoch = this->Epoch;
+		this->Count++;
+	}
+
+	this->Table[i].Position = position;
+}
+
+
+//
+// Clear:
+//
+// Removes every entry in O(1) by starting a new epoch; entries with an
+// old epoch are free.  Entries are never removed otherwise, so a probe
+// sequence always ends at the first free slot.  The table keeps its
+// size for the next query.
+//
+template <typename Vertex, typename Allocator>
+void HashIndex<Vertex, Allocator>::Clear()
+{
+	this->Epoch++;
+	this->Count = 0;
+
+	if (this->Epoch == 0)  // wrapped around:
+	{
+		for (size_t i = 0; i <= this->Mask; ++i)
+			this->Table[i].Epoch = 0;
+
+		this->Epoch = 1;
+	}
+}
+
+
+//
+// hash of a vertex id: the splitmix64 finalizer, so that runs of
+// consecutive ids spread over the whole table:
+//
+template <typename Vertex, typename Allocator>
+inline size_t HashIndex<Vertex, Allocator>::hash(Vertex v)
+{
+	uint64_t x = (uint64_t)v;
+
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+
+	return (size_t)x;
+}
+
+
+//
+// slot holding v, or the free slot where v would be inserted:
+//
+template <typename Vertex, typename Allocator>
+inline size_t HashIndex<Vertex, Allocator>::probe(Vertex v) const
+{
+	size_t i = hash(v) & this->Mask;
+
+	while (this->Table[i].Epoch == this->Epoch && this->Table[i].Id != v)
+		i = (i + 1) & this->Mask;
+
+	return i;
+}
+
+
+//
+// doubles the table, re-inserting the entries of the current epoch:
+//
+template <typename Vertex, typename Allocator>
+void HashIndex<Vertex, Allocator>::grow()
+{
+	Entry  *old = this->Table;
+	size_t  oldSize = this->Mask + 1;
+	size_t  newSize = oldSize * 2;
+
+	this->Table = AllocateArray<Entry>(this->Alloc, newSize);
+	this->Mask = newSize - 1;
+
+	for (size_t i = 0; i < newSize; ++i)
+		this->Table[i].Epoch = 0;
+
+	for (size_t i = 0; i < oldSize; ++i)
+	{
+		if (old[i].Epoch == this->Epoch)
+			this->Table[this->probe(old[i].Id)] = old[i];
+	}
+
+	DeallocateArray(this->Alloc, old, oldSize);
+}
@@ -0,0 +1,37 @@
+/*pqcheck.h*/
+
+//
+//   Argument checking for the priority queues.  By default every queue
+// operation validates its arguments and throws a logic_error on misuse
+// ("checked" build).  Defining PQUEUE_UNCHECKED (e.g. -DPQUEUE_UNCHECKED
+// for a release build) compiles the checks out entirely, and makes
+// Push, DecreaseKey, IncreaseKey, PopMin and Empty noexcept, so tight
+// relaxation loops need no exception handling.
+//
+//   In an unchecked build misuse is undefined behavior: the caller must
+// only pop a non-empty queue, push vertices 0..N-1, and so on.  An
+// allocation failure while growing a queue ends the program.
+//
+
+#pragma once
+
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+
+#if defined(PQUEUE_UNCHECKED)
+
+#define PQUEUE_NOTHROW  true
+#define PQUEUE_CHECK(condition, message)  ((void)0)
+
+#else
+
+#define PQUEUE_NOTHROW  false
+#define PQUEUE_CHECK(condition, message)  \
+	do { if (!(condition)) throw logic_error(message); } while (0)
+
+#endif
+
+#define PQUEUE_NOEXCEPT  noexcept(PQUEUE_NOTHROW)
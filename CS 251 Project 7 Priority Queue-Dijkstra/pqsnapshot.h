@@ -0,0 +1,70 @@
+/*pqsnapshot.h*/
+
+//
+//   The binary snapshot format of PQueue::SaveSnapshot / LoadSnapshot,
+// which captures the complete state of a queue (e.g. in the middle of
+// a query) so it can be restored later, or elsewhere, and the query
+// continued from there.
+//
+//   Layout (in host byte order, see FILE_BYTE_ORDER_MARK in mappedfile.h):
+//
+//     PQueueSnapshotHeader   64 bytes
+//     fill distance          Key
+//     keys                   Key[NumElements]          heap order
+//     vertices               VertexType[NumElements]   heap order
+//     removed                VertexType[NumRemoved]
+//
+// The heap is stored as is, so restoring it needs no sifting.  If
+// vertices are still implicitly queued by FillLazy, they are not listed;
+// instead, removed lists the vertices at or above ImplicitCursor that
+// were popped since the FillLazy.
+//
+//   Version history:
+//     1 -- initial version.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "mappedfile.h"
+
+using namespace std;
+
+
+struct PQueueSnapshotHeader
+{
+  char      Magic[8];        // "PQSNAPS\0"
+  uint32_t  Version;         // PQUEUE_SNAPSHOT_VERSION
+  uint32_t  ByteOrder;       // FILE_BYTE_ORDER_MARK
+  uint32_t  KeyKind;         // PQueueSnapshotKeyKind<Key>()
+  uint32_t  KeySize;         // sizeof(Key)
+  uint32_t  VertexSize;      // sizeof(VertexType)
+  uint32_t  Flags;           // PQUEUE_SNAPSHOT_FILLED
+  int64_t   Capacity;        // N of the queue
+  int64_t   NumElements;     // # of elements in the heap
+  int64_t   ImplicitCursor;  // see PQueue, if FILLED
+  int64_t   NumRemoved;      // # of removed vertices, if FILLED
+};
+
+static_assert(sizeof(PQueueSnapshotHeader) == 64, "snapshot header must be 64 bytes");
+
+const uint32_t PQUEUE_SNAPSHOT_VERSION = 1;
+const uint32_t PQUEUE_SNAPSHOT_FILLED = 1;  // vertices are implicitly queued by FillLazy
+
+
+//
+// the kind of key stored in the header, together with its size:
+// 1 = unsigned integer, 2 = signed integer, 3 = floating point.
+//
+template <typename Key>
+uint32_t PQueueSnapshotKeyKind()
+{
+	if (is_floating_point<Key>::value)
+		return 3;
+	else if (is_signed<Key>::value)
+		return 2;
+	else
+		return 1;
+}
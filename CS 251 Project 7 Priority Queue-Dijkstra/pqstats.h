@@ -0,0 +1,59 @@
+/*pqstats.h*/
+
+//
+//   Operation counters for PQueue, to see where a workload spends its
+// time: how many pushes insert a vertex versus update a queued one,
+// how many levels the sifts move elements, and so on.  The counters
+// are compiled in only when the build defines PQUEUE_STATS (e.g.
+// -DPQUEUE_STATS); otherwise every counting statement expands to
+// nothing, the queue carries no counters, and Stats() returns zeros.
+//
+//   The setting changes the layout of PQueue, so like PQUEUE_UNCHECKED
+// it must be the same for every file of a program.
+//
+
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+
+using namespace std;
+
+
+#if defined(PQUEUE_STATS)
+
+#define PQUEUE_STATS_ENABLED  true
+#define PQUEUE_COUNT(statement)  do { statement; } while (0)
+
+#else
+
+#define PQUEUE_STATS_ENABLED  false
+#define PQUEUE_COUNT(statement)  ((void)0)
+
+#endif
+
+
+struct PQueueStats
+{
+  uint64_t  Inserts = 0;         // pushes of a vertex not in the heap
+  uint64_t  Updates = 0;         // pushes of a vertex already in the heap
+  uint64_t  SiftUpLevels = 0;    // levels moved up, by pushes, updates and deletes
+  uint64_t  SiftDownLevels = 0;  // levels moved down, by pops, updates and rebuilds
+  uint64_t  PopMins = 0;         // PopMin calls (including those of PopMinBatch)
+  uint64_t  Fills = 0;           // Fill and FillLazy calls
+  int       PeakElements = 0;    // largest # of elements in the heap at once
+
+  //
+  // prints the counters, one per line, indented for the driver:
+  //
+  void Print(ostream& out) const
+  {
+    out << "  inserts: " << this->Inserts << endl;
+    out << "  updates: " << this->Updates << endl;
+    out << "  sift-up levels: " << this->SiftUpLevels << endl;
+    out << "  sift-down levels: " << this->SiftDownLevels << endl;
+    out << "  pops: " << this->PopMins << endl;
+    out << "  fills: " << this->Fills << endl;
+    out << "  peak elements: " << this->PeakElements << endl;
+  }
+};
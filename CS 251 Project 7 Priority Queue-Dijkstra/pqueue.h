@@ -1,67 +1,1282 @@
 /*pqueue.h*/
 
+//
+//   A priority queue specifically designed for Dijkstra's shortest
+// weighted path algorithm.  Allows for storing (vertex, distance)
+// pairs, with ability for both O(logN) pop and push.  Unlike 
+// traditional priority queues, this version deletes an existing
+// (vertex, distance) pair if a new pair is pushed with the same
+// vertex --- this occurs in Dijkstra's algorithm when there exists
+// a path to V, but then a better path is found and V's distance
+// must be updated.
+//
+//   Internally, a min-heap is used along with a hash table to keep
+// track of where vertices are currently positioned in the heap.  The
+// heap is d-ary, with the branching factor given by the Arity template
+// parameter (binary by default).  A wider heap is shallower, which
+// speeds up Push / DecreaseKey, and PopMin compares all Arity children
+// of a node, which sit next to each other in memory.
+//
+//   Distances have type Key, double by default.  Integer-weighted
+// graphs can use a 32-bit key such as uint32_t or float instead, which
+// halves the size of the key array that sift-down has to walk.
+//
+//   The arrays come from Allocator, a standard allocator rebound to each
+// element type.  The default AlignedAllocator aligns them to 64 bytes;
+// see allocator.h for huge-page and arena backed storage.
+//
+//   Arguments are checked, throwing logic_error on misuse, unless the
+// build defines PQUEUE_UNCHECKED (see pqcheck.h).  Operation counters
+// are kept, and returned by Stats(), if it defines PQUEUE_STATS (see
+// pqstats.h).
+//
+//   SaveSnapshot / LoadSnapshot write and read the complete state of a
+// queue in a binary format (see pqsnapshot.h), to capture a queue in
+// the middle of a query and continue it elsewhere.
+//
+//   The position of every vertex is tracked by Index, DenseIndex (an
+// array over 0..N-1) by default or HashIndex for sparse or 64-bit
+// vertex ids; see positionindex.h.
+//
+
 #pragma once
 
+#include <iostream>
+#include <iomanip>
+#include <fstream>
 #include <string>
+#include <cstring>
 #include <exception>
 #include <stdexcept>
+#include <cstdint>
+#include <memory>
+#include <limits>
+#include <functional>
+
+#include <vector>
+#include <algorithm>
+
+#include "allocator.h"
+#include "argmin.h"
+#include "pqcheck.h"
+#include "pqstats.h"
+#include "pqsnapshot.h"
+#include "positionindex.h"
 
 using namespace std;
 
 
+template <int Arity = 2, typename Key = double,
+          typename Allocator = AlignedAllocator<Key>, typename Index = DenseIndex<Allocator>>
 class PQueue
 {
+  static_assert(Arity >= 2, "PQueue arity must be at least 2");
+
+public:
+  typedef Key KeyType;
+  typedef Allocator AllocatorType;
+  typedef typename Index::VertexType VertexType;
+
 private:
-  class Elem
-  {
-  public:
-    int     V;
-    double  D;
-
-    Elem()  // default constructor:
-    {
-      V = -1;
-      D = -1.0;
-    }
-
-    Elem(int v, double d)
-    {
-      V = v;
-      D = d;
-    }
-  };
-
-  int  *Positions;    // position of every vertex in queue (-1 if not present)
-  Elem *Queue;        // actual priority queue
-
-  int   NumElements;  // # of elements currently in queue
-  int   Capacity;     // max # of vertices we can support
-
-  void Insert(int v, double d);
-  int  Delete(int position);
-
-  // added functions
-  int getSmallerChild(int position);
-  bool inCorrectSpotwithRespectToParent(int position);
-  bool inCorrectSpotwithRespectToChild(int position);
-  void swap(int position);
+  //
+  // the heap is stored as a structure of arrays: sift comparisons only
+  // read Keys, so keeping them contiguous packs more keys per cache line.
+  // The arrays grow by doubling, so they are sized by the # of vertices
+  // actually queued rather than by N.
+  //
+  Key         *Keys;      // distance of the element at each heap position
+  VertexType  *Vertices;  // vertex of the element at each heap position
+
+  int   NumElements;   // # of elements currently in the heap
+  int   HeapCapacity;  // # of elements the heap arrays can hold
+  int   Capacity;      // # of vertices 0..N-1 for Fill / BuildFrom
+
+  //
+  // position of every vertex in the heap.  Each Fill / FillLazy / Reset
+  // starts a new epoch of the index in O(1); after FillLazy, a vertex
+  // untouched since is implicitly queued at FillDistance until it is
+  // pushed or popped.
+  //
+  Index       Positions;
+
+  bool        Filled;          // are untouched vertices implicitly queued?
+  Key         FillDistance;    // distance of the implicitly queued vertices
+  int         NumImplicit;     // # of vertices still implicitly queued
+  int         ImplicitCursor;  // every vertex below this one has been touched
+
+  static const int IMPLICIT = -2;  // positionOf an implicitly queued vertex
+  static const int INITIAL_HEAP_CAPACITY = 16;
+
+  Allocator   Alloc;   // source of the Keys and Vertices arrays
+
+#if defined(PQUEUE_STATS)
+  PQueueStats Counters;
+#endif
+
+  void Insert(VertexType v, Key d);
+  void append(VertexType v, Key d);
+  VertexType Delete(int position);
+
+  int  positionOf(VertexType v);
+  void reserve(int n);
+  void newEpoch();
+  int  materialize(VertexType v);
+  VertexType popImplicit();
+  VertexType nextImplicit();
+  bool implicitFront();
+  void heapify();
+
+  // added functions, sift kernels are defined inline below:
   void shiftDown(int position);
   void shiftUp(int position);
-  int getRightChildIndex(int position);
-  int getLeftChildIndex(int position);
+  int getFirstChildIndex(int position);
   int getParentIndex(int position);
 
 
-
 public:
-  PQueue(int N);  // constructor:
+  PQueue(int N, const Allocator& allocator = Allocator());  // constructor:
   ~PQueue();      // destructor:
 
-  void Fill(double distance);  
+  void Fill(Key distance);  
+  void FillLazy(Key distance);
+  void BuildFrom(const Key* distances);
+  void Reset();
+
+  void Push(VertexType vertex, Key distance) PQUEUE_NOEXCEPT;
+  void DecreaseKey(VertexType vertex, Key distance) PQUEUE_NOEXCEPT;
+  void IncreaseKey(VertexType vertex, Key distance) PQUEUE_NOEXCEPT;
+  VertexType PopMin() PQUEUE_NOEXCEPT;
+  void PopMin(VertexType& vertex, Key& distance) PQUEUE_NOEXCEPT;
+  VertexType Top() PQUEUE_NOEXCEPT;
+  Key  TopDistance() PQUEUE_NOEXCEPT;
+  bool Empty() PQUEUE_NOEXCEPT;
+
+  void   PushBatch(const VertexType* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT;
+  size_t PopMinBatch(size_t k, VertexType* out) PQUEUE_NOEXCEPT;
 
-  void Push(int vertex, double distance);
-  int  PopMin();
-  bool Empty();
+  PQueueStats Stats() const;  // operation counters, zeros unless PQUEUE_STATS:
+  void ResetStats();
+
+  void SaveSnapshot(const string& path);
+  void LoadSnapshot(const string& path);
 
   void Dump(string title);  // debugging output of contents:
 };
+
+
+//
+// SparsePQueue:
+//
+// A PQueue whose positions are kept in a hash table instead of an
+// N-sized array, for sparse or 64-bit vertex ids: memory scales with
+// the # of vertices touched, and N only bounds Fill / BuildFrom.
+//
+template <int Arity = 2, typename Key = double, typename Vertex = int64_t>
+using SparsePQueue = PQueue<Arity, Key, AlignedAllocator<Key>, HashIndex<Vertex, AlignedAllocator<Key>>>;
+
+
+//
+// Constructor:
+//
+// N is the # of vertices, numbered 0..N-1 (with a HashIndex, any id can
+// be pushed, and N only bounds Fill / BuildFrom).  The heap starts
+// small and grows as needed; its arrays come from the given allocator.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+PQueue<Arity, Key, Allocator, Index>::PQueue(int N, const Allocator& allocator)
+	: Positions(N, allocator), Alloc(allocator)
+{
+	this->HeapCapacity = INITIAL_HEAP_CAPACITY;
+	this->Keys = AllocateArray<Key>(this->Alloc, (size_t)this->HeapCapacity);                // queue itself, distances
+	this->Vertices = AllocateArray<VertexType>(this->Alloc, (size_t)this->HeapCapacity);     // and vertices
+
+	this->Capacity = N;
+	this->NumElements = 0;  // initially empty
+
+	this->Filled = false;
+	this->FillDistance = Key();
+	this->NumImplicit = 0;
+	this->ImplicitCursor = 0;
+}
+
+
+// 
+// Destructor:
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+PQueue<Arity, Key, Allocator, Index>::~PQueue()
+{
+	DeallocateArray(this->Alloc, this->Keys, (size_t)this->HeapCapacity);
+	DeallocateArray(this->Alloc, this->Vertices, (size_t)this->HeapCapacity);
+}
+
+
+//
+// Fill:
+//
+// Initializes the queue such that all N vertices are assigned
+// the same distance.  This is equivalent to making N calls to
+// Push(V, D):
+//
+//   foreach vertex v = 0..N-1
+//     push(v, distance);
+//
+// The vertices are stored in the heap in order, which takes O(N) time;
+// see FillLazy for an O(1) version.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::Fill(Key distance)
+{
+	PQUEUE_COUNT(this->Counters.Fills++);
+
+	this->newEpoch();
+	this->reserve(this->Capacity);
+
+	//
+	// pre-fill the queue, assigning every vertex the same distance
+	// (equal keys already form a heap):
+	//
+	for (int v = 0; v < this->Capacity; ++v)
+	{
+		this->Keys[v] = distance;
+		this->Vertices[v] = (VertexType)v;
+
+		this->Positions.Set((VertexType)v, v);
+	}
+
+	this->NumElements = this->Capacity;
+	PQUEUE_COUNT(this->Counters.PeakElements = max(this->Counters.PeakElements, this->NumElements));
+}
+
+
+//
+// FillLazy:
+//
+// Same contents as Fill, but takes O(1) time: the vertices are queued
+// implicitly, and only materialized in the heap when they are pushed
+// or popped, so a query that reaches few of them never pays for all
+// N.  Dump summarizes the implicit vertices, and vertices at equal
+// distances may pop in a different order than after Fill.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::FillLazy(Key distance)
+{
+	PQUEUE_COUNT(this->Counters.Fills++);
+
+	this->newEpoch();
+
+	this->Filled = true;
+	this->FillDistance = distance;
+	this->NumImplicit = this->Capacity;
+}
+
+
+//
+// Reset:
+//
+// Empties the queue, so the same instance can serve the next query.
+// Only the epoch is bumped, the previous contents are not touched, so
+// this is O(1) no matter how many vertices the last query reached.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::Reset()
+{
+	this->newEpoch();
+}
+
+
+//
+// BuildFrom:
+//
+// Initializes the queue with all N vertices, vertex v at distance
+// distances[v], replacing the current contents.  The heap is built
+// bottom-up in O(N), instead of the O(NlogN) of N calls to Push.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::BuildFrom(const Key* distances)
+{
+	this->newEpoch();
+	this->reserve(this->Capacity);
+
+	for (int v = 0; v < this->Capacity; ++v)
+	{
+		this->Keys[v] = distances[v];
+		this->Vertices[v] = (VertexType)v;
+
+		this->Positions.Set((VertexType)v, v);
+	}
+
+	this->NumElements = this->Capacity;
+	PQUEUE_COUNT(this->Counters.PeakElements = max(this->Counters.PeakElements, this->NumElements));
+
+	this->heapify();
+}
+
+
+//
+// Push:
+//
+// Inserts the given pair (vertex, distance) into the priority
+// queue in ascending order by distance.  If two elements of the
+// queue have the same distance D, which one comes first is 
+// undefined.
+//
+// NOTE: if the vertex is already in the queue with distance D,
+// then the existing (vertex, D) pair is replaced by the new
+// (vertex, distance) pair, via DecreaseKey or IncreaseKey.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::Push(VertexType vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(this->Positions.Valid(vertex),
+		"Invalid vertex passed to PQueue::Push, must be 0..N-1");
+
+	//
+	// Is the vertex already in the queue?  If so, update the existing
+	// (vertex, distance) element in place --- this only has to sift in
+	// one direction, which is far cheaper than a delete + re-insert:
+	//
+	int position = this->positionOf(vertex);
+
+	if (position >= 0)  // vertex is currently stored in the queue:
+	{
+		PQUEUE_COUNT(this->Counters.Updates++);
+
+		if (distance < this->Keys[position])
+			this->DecreaseKey(vertex, distance);
+		else if (distance > this->Keys[position])
+			this->IncreaseKey(vertex, distance);
+
+		// else same distance, nothing to do:
+		return;
+	}
+
+	//
+	// At this point the vertex is not in the heap (though it may be
+	// implicitly queued by FillLazy), so now we do a normal insert into a
+	// min heap:
+	//
+	if (position == IMPLICIT)
+		this->NumImplicit--;
+
+	PQUEUE_COUNT(this->Counters.Inserts++);
+
+	this->Insert(vertex, distance);
+
+	// success:
+	return;
+}
+
+
+//
+// DecreaseKey:
+//
+// Lowers the distance of a vertex that is currently in the queue,
+// updating its element in place and sifting it up towards the front.
+// This is the common case in Dijkstra's algorithm, when a better path
+// to an already queued vertex is found.  Throws a logic_error if the
+// vertex is not in the queue, or if the new distance is larger than
+// the current one.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::DecreaseKey(VertexType vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(this->Positions.Valid(vertex),
+		"Invalid vertex passed to PQueue::DecreaseKey, must be 0..N-1");
+
+	int position = this->positionOf(vertex);
+
+	if (position == IMPLICIT)  // queued by FillLazy, bring it into the heap:
+		position = this->materialize(vertex);
+
+	PQUEUE_CHECK(position >= 0,
+		"Vertex passed to PQueue::DecreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance > this->Keys[position]),
+		"Distance passed to PQueue::DecreaseKey is larger than current distance");
+
+	this->Keys[position] = distance;
+
+	if (position > 0)
+		this->shiftUp(position);
+}
+
+
+//
+// IncreaseKey:
+//
+// Raises the distance of a vertex that is currently in the queue,
+// updating its element in place and sifting it down away from the
+// front.  Throws a logic_error if the vertex is not in the queue, or
+// if the new distance is smaller than the current one.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::IncreaseKey(VertexType vertex, Key distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(this->Positions.Valid(vertex),
+		"Invalid vertex passed to PQueue::IncreaseKey, must be 0..N-1");
+
+	int position = this->positionOf(vertex);
+
+	if (position == IMPLICIT)  // queued by FillLazy, bring it into the heap:
+		position = this->materialize(vertex);
+
+	PQUEUE_CHECK(position >= 0,
+		"Vertex passed to PQueue::IncreaseKey is not in queue");
+	PQUEUE_CHECK(!(distance < this->Keys[position]),
+		"Distance passed to PQueue::IncreaseKey is smaller than current distance");
+
+	this->Keys[position] = distance;
+
+	this->shiftDown(position);
+}
+
+
+//
+// PopMin:
+//
+// Pops (and removes) the (vertex, distance) pair at the front of
+// the queue, and returns vertex.  If the queue is empty, then this
+// operation is an error and so a logic_error exception is thrown
+// with the error message "stack empty!" (unless PQUEUE_UNCHECKED).
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+typename PQueue<Arity, Key, Allocator, Index>::VertexType PQueue<Arity, Key, Allocator, Index>::PopMin() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+	PQUEUE_COUNT(this->Counters.PopMins++);
+
+	if (this->implicitFront())
+		return this->popImplicit();
+
+	VertexType v = this->Delete(0);  // min element is at front => position 0:
+
+	return v;
+}
+
+
+//
+// PopMin(vertex, distance):
+//
+// Same as PopMin(), but also returns the popped vertex's distance, so
+// the caller does not have to look it up.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::PopMin(VertexType& vertex, Key& distance) PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+	PQUEUE_COUNT(this->Counters.PopMins++);
+
+	if (this->implicitFront())
+	{
+		distance = this->FillDistance;
+		vertex = this->popImplicit();
+		return;
+	}
+
+	distance = this->Keys[0];
+	vertex = this->Delete(0);
+}
+
+
+//
+// Top / TopDistance:
+//
+// The vertex PopMin would return next, and its distance, without
+// removing it.  Throws a logic_error "stack empty!" if the queue is
+// empty (unless PQUEUE_UNCHECKED).
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+typename PQueue<Arity, Key, Allocator, Index>::VertexType PQueue<Arity, Key, Allocator, Index>::Top() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	if (this->implicitFront())
+		return this->nextImplicit();
+
+	return this->Vertices[0];
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+Key PQueue<Arity, Key, Allocator, Index>::TopDistance() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	if (this->implicitFront())
+		return this->FillDistance;
+
+	return this->Keys[0];
+}
+
+
+//
+// PushBatch:
+//
+// Pushes (vertices[i], distances[i]) for i = 0..n-1, with the same
+// meaning as n calls to Push.  A batch that is large relative to the
+// heap is applied without sifting and the heap is then rebuilt
+// bottom-up, which is cheaper than sifting every element on its own.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::PushBatch(const VertexType* vertices, const Key* distances, size_t n) PQUEUE_NOEXCEPT
+{
+	//
+	// n pushes cost about n * depth sift steps, a rebuild about one step
+	// per element of the resulting heap:
+	//
+	size_t total = (size_t)this->NumElements + n;
+	size_t depth = 1;
+
+	for (size_t m = total; m > (size_t)Arity; m /= Arity)
+		depth++;
+
+	if (n * depth < total)
+	{
+		for (size_t i = 0; i < n; ++i)
+			this->Push(vertices[i], distances[i]);
+
+		return;
+	}
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		VertexType vertex = vertices[i];
+
+		PQUEUE_CHECK(this->Positions.Valid(vertex),
+			"Invalid vertex passed to PQueue::PushBatch, must be 0..N-1");
+
+		int position = this->positionOf(vertex);
+
+		if (position >= 0)  // already in the heap, the rebuild will sift it:
+		{
+			PQUEUE_COUNT(this->Counters.Updates++);
+
+			this->Keys[position] = distances[i];
+			continue;
+		}
+
+		if (position == IMPLICIT)
+			this->NumImplicit--;
+
+		PQUEUE_COUNT(this->Counters.Inserts++);
+
+		this->append(vertex, distances[i]);
+	}
+
+	this->heapify();
+}
+
+
+//
+// PopMinBatch:
+//
+// Pops up to k vertices in ascending order of distance into out[], and
+// returns how many were popped (fewer than k if the queue runs empty).
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+size_t PQueue<Arity, Key, Allocator, Index>::PopMinBatch(size_t k, VertexType* out) PQUEUE_NOEXCEPT
+{
+	size_t count = 0;
+
+	while (count < k && !this->Empty())
+	{
+		out[count] = this->PopMin();
+		count++;
+	}
+
+	return count;
+}
+
+
+//
+// Empty:
+//
+// Returns true if the queue is empty, false if not.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+bool PQueue<Arity, Key, Allocator, Index>::Empty() PQUEUE_NOEXCEPT
+{
+	return (this->NumElements == 0 && this->NumImplicit == 0);
+}
+
+
+//
+// Stats:
+//
+// The operation counters since construction or the last ResetStats.
+// Reset and Fill do not clear them, so they can cover a whole series
+// of queries.  All zeros unless the build defines PQUEUE_STATS.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+PQueueStats PQueue<Arity, Key, Allocator, Index>::Stats() const
+{
+#if defined(PQUEUE_STATS)
+	return this->Counters;
+#else
+	return PQueueStats();
+#endif
+}
+
+
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::ResetStats()
+{
+	PQUEUE_COUNT(this->Counters = PQueueStats());
+}
+
+
+//
+// Dump:
+//
+// Dumps the contents of the queue to the console; this is for
+// debugging purposes.  A queue of 100+ elements is summarized, in time
+// linear in its size and independent of N.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::Dump(string title)
+{
+	cout << ">>PQueue: " << title << endl;
+
+	cout << "  # elements: " << this->NumElements + this->NumImplicit << endl;
+
+	cout << std::fixed;
+	cout << std::setprecision(2);
+
+	if (this->NumImplicit > 0)
+		cout << "  implicit: " << this->NumImplicit << " vertices at distance "
+			<< this->FillDistance << endl;
+
+	if (this->NumElements == 0)  // no output:
+		;
+	else if (this->NumElements < 100)  // smallish, can print entire contents:
+	{
+		cout << std::fixed;
+		cout << std::setprecision(2);
+
+		cout << "  ";
+		for (int i = 0; i < this->NumElements; ++i)
+		{
+			cout << "(" << this->Vertices[i] << "," << this->Keys[i] << ") ";
+		}
+
+		cout << endl;
+
+		//
+		// the positions are listed by vertex, so collect the queued
+		// vertices in order (the index may be sparse):
+		//
+		vector<VertexType> queued(this->Vertices, this->Vertices + this->NumElements);
+		sort(queued.begin(), queued.end());
+
+		cout << "  Positions: ";
+		for (VertexType v : queued)
+		{
+			cout << "(" << v << "@" << this->Positions.Find(v) << ") ";
+		}
+
+		cout << endl;
+	}
+	else  // Graph contains 100+ elements, so let's print a summary:
+	{
+		cout << std::fixed;
+		cout << std::setprecision(2);
+
+		cout << "  ";
+		for (int i = 0; i < 3; ++i)
+		{
+			cout << "(" << this->Vertices[i] << "," << this->Keys[i] << ") ";
+		}
+		cout << "... ";
+		for (int i = this->NumElements - 3; i < this->NumElements; ++i)
+		{
+			cout << "(" << this->Vertices[i] << "," << this->Keys[i] << ") ";
+		}
+		cout << endl;
+
+		//
+		// the 3 lowest and 3 highest queued vertices are picked in one
+		// pass over the heap, without copying or sorting it:
+		//
+		VertexType lowest[3], highest[3];
+
+		partial_sort_copy(this->Vertices, this->Vertices + this->NumElements, lowest, lowest + 3);
+		partial_sort_copy(this->Vertices, this->Vertices + this->NumElements, highest, highest + 3,
+			greater<VertexType>());
+
+		cout << "  Positions: ";
+		for (int i = 0; i < 3; ++i)
+		{
+			cout << "(" << lowest[i] << "@" << this->Positions.Find(lowest[i]) << ") ";
+		}
+		cout << "... ";
+		for (int i = 2; i >= 0; --i)
+		{
+			cout << "(" << highest[i] << "@" << this->Positions.Find(highest[i]) << ") ";
+		}
+		cout << endl;
+
+	}
+}
+
+
+//
+// SaveSnapshot:
+//
+// Writes the state of the queue to path (see pqsnapshot.h), leaving the
+// queue unchanged.  Takes time linear in the # of elements, plus O(N)
+// while vertices are still implicitly queued by FillLazy.  Throws a
+// logic_error if the file cannot be written.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::SaveSnapshot(const string& path)
+{
+	PQueueSnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.Magic, "PQSNAPS", 8);
+	header.Version = PQUEUE_SNAPSHOT_VERSION;
+	header.ByteOrder = FILE_BYTE_ORDER_MARK;
+	header.KeyKind = PQueueSnapshotKeyKind<Key>();
+	header.KeySize = sizeof(Key);
+	header.VertexSize = sizeof(VertexType);
+	header.Capacity = this->Capacity;
+	header.NumElements = this->NumElements;
+
+	//
+	// with no vertex left implicitly queued, a filled queue behaves like
+	// any other, so only the heap is saved:
+	//
+	vector<VertexType> removed;
+
+	if (this->NumImplicit > 0)
+	{
+		header.Flags = PQUEUE_SNAPSHOT_FILLED;
+		header.ImplicitCursor = this->ImplicitCursor;
+
+		for (int v = this->ImplicitCursor; v < this->Capacity; ++v)
+		{
+			if (this->Positions.Find((VertexType)v) == -1)  // popped since the FillLazy:
+				removed.push_back((VertexType)v);
+		}
+
+		header.NumRemoved = (int64_t)removed.size();
+	}
+
+	ofstream file(path, ios::binary | ios::trunc);
+
+	if (!file.good())
+		throw logic_error("PQueue::SaveSnapshot: unable to create '" + path + "'");
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&this->FillDistance, sizeof(Key));
+	file.write((const char*)this->Keys, (streamsize)this->NumElements * sizeof(Key));
+	file.write((const char*)this->Vertices, (streamsize)this->NumElements * sizeof(VertexType));
+	file.write((const char*)removed.data(), (streamsize)removed.size() * sizeof(VertexType));
+
+	file.close();
+
+	if (file.fail())
+		throw logic_error("PQueue::SaveSnapshot: unable to write '" + path + "'");
+}
+
+
+//
+// LoadSnapshot:
+//
+// Replaces the contents of the queue with the state saved at path by
+// SaveSnapshot, from a queue of the same type and N.  The heap is
+// checked before it is used (format, vertices, no duplicates, heap
+// order).  Throws a logic_error, leaving the queue empty, if the
+// snapshot cannot be used.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::LoadSnapshot(const string& path)
+{
+	ifstream file(path, ios::binary);
+
+	if (!file.good())
+		throw logic_error("PQueue::LoadSnapshot: unable to open '" + path + "'");
+
+	this->newEpoch();
+
+	auto fail = [&](const string& problem)
+	{
+		this->newEpoch();
+		throw logic_error("PQueue::LoadSnapshot: '" + path + "' " + problem);
+	};
+
+	PQueueSnapshotHeader header;
+
+	if (!file.read((char*)&header, sizeof(header)) || memcmp(header.Magic, "PQSNAPS", 8) != 0)
+		fail("is not a queue snapshot");
+	if (header.Version != PQUEUE_SNAPSHOT_VERSION)
+		fail("has an unsupported version");
+	if (header.ByteOrder != FILE_BYTE_ORDER_MARK)
+		fail("was written with a different byte order");
+	if (header.KeyKind != PQueueSnapshotKeyKind<Key>() || header.KeySize != sizeof(Key)
+		|| header.VertexSize != sizeof(VertexType))
+		fail("has a different key or vertex type");
+	if (header.Capacity != this->Capacity)
+		fail("was saved from a queue with a different N");
+
+	bool filled = (header.Flags & PQUEUE_SNAPSHOT_FILLED) != 0;
+
+	if (header.NumElements < 0 || header.NumElements > numeric_limits<int>::max()
+		|| (filled && (header.ImplicitCursor < 0 || header.ImplicitCursor > header.Capacity
+			|| header.NumRemoved < 0 || header.NumRemoved > header.Capacity)))
+		fail("is corrupt");
+
+	int n = (int)header.NumElements;
+
+	this->reserve(n);
+
+	Key fillDistance;
+
+	if (!file.read((char*)&fillDistance, sizeof(Key))
+		|| !file.read((char*)this->Keys, (streamsize)n * sizeof(Key))
+		|| !file.read((char*)this->Vertices, (streamsize)n * sizeof(VertexType)))
+		fail("is truncated");
+
+	for (int i = 0; i < n; ++i)
+	{
+		VertexType v = this->Vertices[i];
+
+		if (!this->Positions.Valid(v) || this->Positions.Find(v) != Index::UNTOUCHED)
+			fail("has an invalid or duplicate vertex");
+		if (i > 0 && this->Keys[i] < this->Keys[this->getParentIndex(i)])
+			fail("is not in heap order");
+
+		this->Positions.Set(v, i);
+	}
+
+	this->NumElements = n;
+
+	if (!filled)
+		return;
+
+	//
+	// restore the implicitly queued vertices: every vertex below the
+	// cursor, and every removed one, has been touched; the others not in
+	// the heap are still queued at the fill distance:
+	//
+	int cursor = (int)header.ImplicitCursor;
+	int above = 0;  // # of heap vertices at or above the cursor
+
+	for (int i = 0; i < n; ++i)
+	{
+		if (this->Vertices[i] >= (VertexType)cursor && this->Vertices[i] < (VertexType)this->Capacity)
+			above++;
+	}
+
+	for (int64_t r = 0; r < header.NumRemoved; ++r)
+	{
+		VertexType v;
+
+		if (!file.read((char*)&v, sizeof(v)))
+			fail("is truncated");
+		if (v < (VertexType)cursor || v >= (VertexType)this->Capacity || this->Positions.Find(v) != Index::UNTOUCHED)
+			fail("has an invalid or duplicate removed vertex");
+
+		this->Positions.Set(v, -1);
+	}
+
+	for (int v = 0; v < cursor; ++v)
+	{
+		if (this->Positions.Find((VertexType)v) == Index::UNTOUCHED)
+			this->Positions.Set((VertexType)v, -1);
+	}
+
+	this->Filled = true;
+	this->FillDistance = fillDistance;
+	this->ImplicitCursor = cursor;
+	this->NumImplicit = this->Capacity - cursor - (int)header.NumRemoved - above;
+
+	if (this->NumImplicit <= 0)
+		fail("is corrupt");
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// Insert:
+// 
+// Inserts the given (vertex, distance) pair into the priority queue; it is
+// assumed that vertex v is *not* in the queue (if it was, you must delete
+// before calling Insert).  Follows standard min-heap insertion algorithm
+// where you insert into last position, and then swap upwards in the tree
+// to it's proper position.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::Insert(VertexType v, Key d)
+{
+	PQUEUE_CHECK(this->Positions.Valid(v),
+		"Invalid vertex passed to PQueue::Insert");
+	PQUEUE_CHECK(this->positionOf(v) < 0,
+		"**Internal error: PQueue::Insert called while vertex is still in queue");
+
+	this->append(v, d);
+
+	// sift the new element up to its proper position:
+	this->shiftUp(this->NumElements - 1);
+}
+
+
+//
+// append:
+//
+// Stores (v, d) in the last position of the heap, without sifting.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline void PQueue<Arity, Key, Allocator, Index>::append(VertexType v, Key d)
+{
+	if (this->NumElements == this->HeapCapacity)
+		this->reserve(this->NumElements + 1);
+
+	this->Keys[this->NumElements] = d;
+	this->Vertices[this->NumElements] = v;
+
+	this->Positions.Set(v, this->NumElements);
+
+	this->NumElements++;
+	PQUEUE_COUNT(this->Counters.PeakElements = max(this->Counters.PeakElements, this->NumElements));
+}
+
+
+//
+// Delete:
+// 
+// Deletes the (vertex, distance) pair at the given position in the queue,
+// where 0 <= position < # of elements.  The deleted vertex v is returned.
+// Use a standard min-heap deletion algorithm where deleted element is 
+// replaced by the last element, and then this element has to be swapped 
+// into position --- this can be upwards or downwards (or not at all).
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+typename PQueue<Arity, Key, Allocator, Index>::VertexType PQueue<Arity, Key, Allocator, Index>::Delete(int position)
+{
+	PQUEUE_CHECK(this->NumElements > 0,
+		"**Internal error: call to PQueue::Delete with an empty queue");
+	PQUEUE_CHECK(position >= 0 && position < this->NumElements,
+		"**Internal error: invalid position in PQueue::Delete");
+
+	// grab the vertex to be returned, it is no longer in the queue
+	VertexType v = this->Vertices[position];
+	this->Positions.Move(v, -1);
+
+	// adjust size of the Queue 
+	this->NumElements--;
+
+	// last element in the array, nothing has to be moved
+	if (position == this->NumElements) {
+		return v;
+	}
+
+	//
+	// more than one element in the array, move the last element into
+	// the hole and update its position
+	//
+	this->Keys[position] = this->Keys[this->NumElements];
+	this->Vertices[position] = this->Vertices[this->NumElements];
+	this->Positions.Move(this->Vertices[position], position);
+
+	//
+	// check for the swap direction: up or down the tree
+	//
+	if (position > 0
+		&& this->Keys[position] < this->Keys[this->getParentIndex(position)]) {
+		this->shiftUp(position);
+	}
+	else {
+		this->shiftDown(position);
+	}
+
+	//
+	// done!
+	//
+	return v;
+}
+
+
+//
+// reserve:
+//
+// Makes room for at least n heap elements, doubling the arrays so a
+// sequence of inserts takes amortized O(1) per element.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::reserve(int n)
+{
+	if (n <= this->HeapCapacity)
+		return;
+
+	int newCapacity = this->HeapCapacity * 2;
+	if (newCapacity < n)
+		newCapacity = n;
+
+	Key        *keys = AllocateArray<Key>(this->Alloc, (size_t)newCapacity);
+	VertexType *vertices = AllocateArray<VertexType>(this->Alloc, (size_t)newCapacity);
+
+	for (int i = 0; i < this->NumElements; ++i)
+	{
+		keys[i] = this->Keys[i];
+		vertices[i] = this->Vertices[i];
+	}
+
+	DeallocateArray(this->Alloc, this->Keys, (size_t)this->HeapCapacity);
+	DeallocateArray(this->Alloc, this->Vertices, (size_t)this->HeapCapacity);
+
+	this->Keys = keys;
+	this->Vertices = vertices;
+	this->HeapCapacity = newCapacity;
+}
+
+
+//
+// newEpoch:
+//
+// Empties the queue in O(1), by starting a new epoch of the position
+// index.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::newEpoch()
+{
+	this->Positions.Clear();
+
+	this->NumElements = 0;
+	this->Filled = false;
+	this->NumImplicit = 0;
+	this->ImplicitCursor = 0;
+}
+
+
+//
+// materialize:
+//
+// Moves a vertex that is implicitly queued by FillLazy into the heap, at
+// the fill distance, and returns its position.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+int PQueue<Arity, Key, Allocator, Index>::materialize(VertexType v)
+{
+	this->NumImplicit--;
+	this->Insert(v, this->FillDistance);
+
+	return this->Positions.Find(v);
+}
+
+
+//
+// popImplicit:
+//
+// Pops one of the vertices still implicitly queued by FillLazy.  They are
+// popped in increasing order of vertex, so the cursor only moves
+// forward and all the pops of one FillLazy together take O(N).
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+typename PQueue<Arity, Key, Allocator, Index>::VertexType PQueue<Arity, Key, Allocator, Index>::popImplicit()
+{
+	VertexType v = this->nextImplicit();
+
+	this->ImplicitCursor++;
+	this->Positions.Set(v, -1);
+	this->NumImplicit--;
+
+	return v;
+}
+
+
+//
+// nextImplicit:
+//
+// The lowest vertex still implicitly queued by FillLazy, moving the cursor
+// past vertices that have been touched since.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline typename PQueue<Arity, Key, Allocator, Index>::VertexType PQueue<Arity, Key, Allocator, Index>::nextImplicit()
+{
+	while (this->Positions.Find((VertexType)this->ImplicitCursor) != Index::UNTOUCHED)  // touched:
+		this->ImplicitCursor++;
+
+	return (VertexType)this->ImplicitCursor;
+}
+
+
+//
+// implicitFront:
+//
+// The front of the queue is either the heap's min element, or one of
+// the vertices still implicitly queued by FillLazy; true if it is the
+// latter.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline bool PQueue<Arity, Key, Allocator, Index>::implicitFront()
+{
+	return this->NumImplicit > 0
+		&& (this->NumElements == 0 || this->FillDistance < this->Keys[0]);
+}
+
+
+//
+// heapify:
+//
+// Floyd's bottom-up heap construction: sifts down every internal node,
+// last one first, which takes O(N) in total.
+//
+template <int Arity, typename Key, typename Allocator, typename Index>
+void PQueue<Arity, Key, Allocator, Index>::heapify()
+{
+	if (this->NumElements < 2)
+		return;
+
+	for (int i = this->getParentIndex(this->NumElements - 1); i >= 0; --i)
+		this->shiftDown(i);
+}
+
+
+/*************************** INLINE SIFT KERNELS *******************************/
+
+//
+// The sift kernels are iterative and hole-based: the moving key and
+// vertex are kept in locals while parents / children are shifted into the hole,
+// so every heap slot and its vertex's Position is written once per level, and
+// the moving element once at the end.
+//
+
+// position of a vertex in the heap, -1 if not queued, or IMPLICIT if
+// it is queued by FillLazy but not yet in the heap
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline int PQueue<Arity, Key, Allocator, Index>::positionOf(VertexType v)
+{
+	int position = this->Positions.Find(v);
+
+	if (position != Index::UNTOUCHED)
+		return position;
+
+	return (this->Filled && v >= 0 && v < this->Capacity) ? IMPLICIT : -1;
+}
+
+
+// return index of first child, the Arity children are contiguous
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline int PQueue<Arity, Key, Allocator, Index>::getFirstChildIndex(int position)
+{
+	return (position * Arity) + 1;
+}
+
+
+// return the index of of parent
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline int PQueue<Arity, Key, Allocator, Index>::getParentIndex(int position)
+{
+	return (position - 1) / Arity;
+}
+
+
+// shifts the node up until its parent is not larger
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline void PQueue<Arity, Key, Allocator, Index>::shiftUp(int position)
+{
+	Key movingKey = this->Keys[position];
+	VertexType movingVertex = this->Vertices[position];
+
+	while (position > 0)
+	{
+		int parentIndex = this->getParentIndex(position);
+
+		if (!(movingKey < this->Keys[parentIndex]))
+			break;
+
+		PQUEUE_COUNT(this->Counters.SiftUpLevels++);
+
+		// move the parent down into the hole:
+		this->Keys[position] = this->Keys[parentIndex];
+		this->Vertices[position] = this->Vertices[parentIndex];
+		this->Positions.Move(this->Vertices[position], position);
+
+		position = parentIndex;
+	}
+
+	this->Keys[position] = movingKey;
+	this->Vertices[position] = movingVertex;
+	this->Positions.Move(movingVertex, position);
+}
+
+
+// shifts the node down until no child is smaller
+template <int Arity, typename Key, typename Allocator, typename Index>
+inline void PQueue<Arity, Key, Allocator, Index>::shiftDown(int position)
+{
+	Key movingKey = this->Keys[position];
+	VertexType movingVertex = this->Vertices[position];
+	int n = this->NumElements;
+
+	while (true)
+	{
+		int firstChildIndex = this->getFirstChildIndex(position);
+
+		if (firstChildIndex >= n)  // leaf:
+			break;
+
+		int lastChildIndex = firstChildIndex + Arity;
+		if (lastChildIndex > n)
+			lastChildIndex = n;
+
+		//
+		// find the smallest child, first one wins on ties.  A full set of
+		// 16+ children is handed to the vectorized ArgMin kernel; below
+		// that the scalar chain measured faster than the kernel call:
+		//
+		int minIndex;
+
+		if (Arity >= 16 && lastChildIndex - firstChildIndex == Arity)
+		{
+			minIndex = firstChildIndex + ArgMin(this->Keys + firstChildIndex, Arity);
+		}
+		else
+		{
+			minIndex = firstChildIndex;
+
+			for (int c = firstChildIndex + 1; c < lastChildIndex; ++c)
+			{
+				if (this->Keys[c] < this->Keys[minIndex])
+					minIndex = c;
+			}
+		}
+
+		if (!(this->Keys[minIndex] < movingKey))
+			break;
+
+		PQUEUE_COUNT(this->Counters.SiftDownLevels++);
+
+		// move the smallest child up into the hole:
+		this->Keys[position] = this->Keys[minIndex];
+		this->Vertices[position] = this->Vertices[minIndex];
+		this->Positions.Move(this->Vertices[position], position);
+
+		position = minIndex;
+	}
+
+	this->Keys[position] = movingKey;
+	this->Vertices[position] = movingVertex;
+	this->Positions.Move(movingVertex, position);
+}
+
+
+//
+// the common configurations are instantiated once in pqueue.cpp:
+//
+extern template class PQueue<2, double>;
+extern template class PQueue<4, double>;
+extern template class PQueue<8, double>;
+extern template class PQueue<16, double>;
+extern template class PQueue<2, float>;
+extern template class PQueue<4, float>;
+extern template class PQueue<8, float>;
+extern template class PQueue<16, float>;
+extern template class PQueue<2, uint32_t>;
+extern template class PQueue<4, uint32_t>;
+extern template class PQueue<8, uint32_t>;
+extern template class PQueue<16, uint32_t>;
+
+extern template class PQueue<2, double, AlignedAllocator<double>, HashIndex<int, AlignedAllocator<double>>>;
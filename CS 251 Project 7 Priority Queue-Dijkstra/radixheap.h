@@ -0,0 +1,495 @@
+/*radixheap.h*/
+
+//
+//   A radix heap: a monotone priority queue for unsigned integer
+// distances, with the same interface as PQueue so it can replace it in
+// the driver and in the Dijkstra engine.  "Monotone" means a pushed
+// distance is never smaller than the last distance popped, which is
+// always true in Dijkstra's algorithm with non-negative edge weights.
+//
+//   Vertices are kept in buckets by the highest bit in which their
+// distance differs from the last popped distance.  Bucket 0 holds the
+// vertices at exactly that distance; when it runs empty, the first
+// non-empty bucket is split into lower buckets around its minimum.  A
+// vertex moves down at most once per bit, so pops are O(bits)
+// amortized, and pushes and decrease-keys are O(1).
+//
+//   If CheckMonotone is true, pushing a distance smaller than the last
+// popped one throws a logic_error; otherwise the pop order is undefined
+// after such a push.  Once the queue runs empty the bound goes back to
+// 0, starting a new monotone sequence, so one queue can serve several
+// Dijkstra runs.
+//
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "pqcheck.h"
+
+using namespace std;
+
+
+template <typename Key = uint32_t, bool CheckMonotone = false>
+class RadixHeap
+{
+  static_assert(is_integral<Key>::value && is_unsigned<Key>::value,
+    "RadixHeap requires an unsigned integer key type");
+
+private:
+  static const int NUM_BUCKETS = numeric_limits<Key>::digits + 1;
+
+  vector<int>   Buckets[NUM_BUCKETS];  // vertices in each bucket
+
+  vector<Key>   Keys;        // distance of every queued vertex
+  vector<int>   Bucket;      // bucket of every vertex (-1 if not present)
+  vector<int>   Slot;        // index of every vertex within its bucket
+
+  Key   Last;          // last distance popped, a lower bound for the queue
+  int   NumElements;   // # of elements currently in queue
+  int   Capacity;      // max # of vertices we can support
+
+  static int bitWidth(uint64_t x);
+  int  bucketOf(Key distance);
+  void insert(int vertex, Key distance);
+  void remove(int vertex);
+  void redistribute();
+  int  minVertex();
+
+public:
+  typedef Key KeyType;
+
+  RadixHeap(int N);  // constructor:
+
+  void Fill(Key distance);
+  void Reset();
+
+  //
+  // the monotone check is requested explicitly, so it is kept in
+  // unchecked builds too, and Push can then still throw:
+  //
+  void Push(int vertex, Key distance) noexcept(PQUEUE_NOTHROW && !CheckMonotone);
+  void DecreaseKey(int vertex, Key distance) noexcept(PQUEUE_NOTHROW && !CheckMonotone) { this->Push(vertex, distance); }
+  void IncreaseKey(int vertex, Key distance) noexcept(PQUEUE_NOTHROW && !CheckMonotone) { this->Push(vertex, distance); }
+  int  PopMin() PQUEUE_NOEXCEPT;
+  void PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT;
+  int  Top() PQUEUE_NOEXCEPT;
+  Key  TopDistance() PQUEUE_NOEXCEPT;
+  bool Empty() PQUEUE_NOEXCEPT;
+
+  // pushes are O(1) already, so the batches are plain loops:
+  void   PushBatch(const int* vertices, const Key* distances, size_t n) noexcept(PQUEUE_NOTHROW && !CheckMonotone);
+  size_t PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT;
+
+  void Dump(string title);  // debugging output of contents:
+};
+
+
+//
+// Constructor:
+//
+// N is the capacity of the queue, vertices are numbered 0..N-1.
+//
+template <typename Key, bool CheckMonotone>
+RadixHeap<Key, CheckMonotone>::RadixHeap(int N)
+	: Keys(N), Bucket(N, -1), Slot(N)
+{
+	this->Last = 0;
+	this->NumElements = 0;
+	this->Capacity = N;
+}
+
+
+//
+// Fill:
+//
+// Replaces the contents of the queue by all N vertices at the same
+// distance; this starts a new monotone sequence, so Fill(infinity)
+// followed by Push(source, 0) is allowed.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::Fill(Key distance)
+{
+	for (vector<int>& bucket : this->Buckets)
+		bucket.clear();
+
+	this->Last = 0;
+
+	int b = this->bucketOf(distance);
+
+	this->Buckets[b].resize(this->Capacity);
+
+	for (int v = 0; v < this->Capacity; ++v)
+	{
+		this->Keys[v] = distance;
+		this->Bucket[v] = b;
+		this->Slot[v] = v;
+		this->Buckets[b][v] = v;
+	}
+
+	this->NumElements = this->Capacity;
+}
+
+
+//
+// Reset:
+//
+// Empties the queue, so the same instance can serve the next query.
+// Only the vertices still in a bucket are cleared, so the cost is
+// proportional to what the last query left queued, not to N.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::Reset()
+{
+	for (vector<int>& bucket : this->Buckets)
+	{
+		for (int v : bucket)
+			this->Bucket[v] = -1;
+
+		bucket.clear();
+	}
+
+	this->Last = 0;
+	this->NumElements = 0;
+}
+
+
+//
+// Push:
+//
+// Inserts (vertex, distance), replacing the vertex's current distance
+// if it is already queued.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::Push(int vertex, Key distance) noexcept(PQUEUE_NOTHROW && !CheckMonotone)
+{
+	PQUEUE_CHECK(vertex >= 0 && vertex < this->Capacity,
+		"Invalid vertex passed to RadixHeap::Push, must be 0..N-1");
+
+	if (this->NumElements == 0)  // start a new monotone sequence:
+		this->Last = 0;
+
+	//
+	// compiled only when requested, so the noexcept instantiation holds no
+	// throw at all:
+	//
+	if constexpr (CheckMonotone)
+	{
+		if (this->NumElements > 0 && distance < this->Last)
+			throw logic_error("Non-monotone distance passed to RadixHeap::Push");
+	}
+
+	if (this->Bucket[vertex] >= 0)  // already queued:
+	{
+		if (this->Keys[vertex] == distance)
+			return;
+
+		this->remove(vertex);
+	}
+
+	this->insert(vertex, distance);
+}
+
+
+//
+// PopMin:
+//
+// Pops (and removes) a vertex with the smallest distance.  If the queue
+// is empty a logic_error "stack empty!" is thrown.
+//
+template <typename Key, bool CheckMonotone>
+int RadixHeap<Key, CheckMonotone>::PopMin() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	if (this->Buckets[0].empty())
+		this->redistribute();
+
+	int v = this->Buckets[0].back();
+
+	this->Buckets[0].pop_back();
+	this->Bucket[v] = -1;
+	this->NumElements--;
+
+	return v;
+}
+
+
+//
+// PopMin(vertex, distance):
+//
+// Same as PopMin(), but also returns the popped vertex's distance.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::PopMin(int& vertex, Key& distance) PQUEUE_NOEXCEPT
+{
+	vertex = this->PopMin();
+	distance = this->Last;  // bucket 0 holds the vertices at distance Last:
+}
+
+
+//
+// Top / TopDistance:
+//
+// A vertex with the smallest distance, and that distance, without
+// removing it.  Top does not redistribute (that would raise the bound
+// for later pushes), so when bucket 0 is empty it scans the first
+// non-empty bucket.  Throws a logic_error "stack empty!" if the queue
+// is empty.
+//
+template <typename Key, bool CheckMonotone>
+int RadixHeap<Key, CheckMonotone>::Top() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->minVertex();
+}
+
+
+template <typename Key, bool CheckMonotone>
+Key RadixHeap<Key, CheckMonotone>::TopDistance() PQUEUE_NOEXCEPT
+{
+	PQUEUE_CHECK(!this->Empty(), "stack empty!");
+
+	return this->Keys[this->minVertex()];
+}
+
+
+//
+// PushBatch:
+//
+// Same as n calls to Push.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::PushBatch(const int* vertices, const Key* distances, size_t n) noexcept(PQUEUE_NOTHROW && !CheckMonotone)
+{
+	for (size_t i = 0; i < n; ++i)
+		this->Push(vertices[i], distances[i]);
+}
+
+
+//
+// PopMinBatch:
+//
+// Pops up to k vertices in ascending order of distance into out[], and
+// returns how many were popped (fewer than k if the queue runs empty).
+//
+template <typename Key, bool CheckMonotone>
+size_t RadixHeap<Key, CheckMonotone>::PopMinBatch(size_t k, int* out) PQUEUE_NOEXCEPT
+{
+	size_t count = 0;
+
+	while (count < k && !this->Empty())
+	{
+		out[count] = this->PopMin();
+		count++;
+	}
+
+	return count;
+}
+
+
+//
+// Empty:
+//
+// Returns true if the queue is empty, false if not.
+//
+template <typename Key, bool CheckMonotone>
+bool RadixHeap<Key, CheckMonotone>::Empty() PQUEUE_NOEXCEPT
+{
+	return (this->NumElements == 0);
+}
+
+
+//
+// Dump:
+//
+// Dumps the contents of every non-empty bucket to the console; this is
+// for debugging purposes.
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::Dump(string title)
+{
+	cout << ">>RadixHeap: " << title << endl;
+
+	cout << "  # elements: " << this->NumElements << endl;
+	cout << "  last popped: " << this->Last << endl;
+
+	int printed = 0;
+
+	for (int b = 0; b < NUM_BUCKETS && printed < 100; ++b)
+	{
+		if (this->Buckets[b].empty())
+			continue;
+
+		cout << "  bucket " << b << ": ";
+
+		for (int v : this->Buckets[b])
+		{
+			if (printed == 100)
+			{
+				cout << "...";
+				break;
+			}
+
+			cout << "(" << v << "," << this->Keys[v] << ") ";
+			printed++;
+		}
+
+		cout << endl;
+	}
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// # of bits needed to represent x, which must be non-zero:
+//
+template <typename Key, bool CheckMonotone>
+inline int RadixHeap<Key, CheckMonotone>::bitWidth(uint64_t x)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+	_BitScanReverse64(&index, x);
+	return (int)index + 1;
+#else
+	if (x >> 32)
+	{
+		_BitScanReverse(&index, (unsigned long)(x >> 32));
+		return (int)index + 33;
+	}
+	_BitScanReverse(&index, (unsigned long)x);
+	return (int)index + 1;
+#endif
+#else
+	return 64 - __builtin_clzll(x);
+#endif
+}
+
+
+//
+// bucket of a distance: 0 if equal to Last, else 1 + the index of the
+// highest bit in which it differs from Last:
+//
+template <typename Key, bool CheckMonotone>
+inline int RadixHeap<Key, CheckMonotone>::bucketOf(Key distance)
+{
+	if (distance == this->Last)
+		return 0;
+
+	return bitWidth((uint64_t)(distance ^ this->Last));
+}
+
+
+template <typename Key, bool CheckMonotone>
+inline void RadixHeap<Key, CheckMonotone>::insert(int vertex, Key distance)
+{
+	int b = this->bucketOf(distance);
+
+	this->Keys[vertex] = distance;
+	this->Bucket[vertex] = b;
+	this->Slot[vertex] = (int)this->Buckets[b].size();
+	this->Buckets[b].push_back(vertex);
+
+	this->NumElements++;
+}
+
+
+//
+// removes a queued vertex from its bucket in O(1), by moving the last
+// vertex of the bucket into its slot:
+//
+template <typename Key, bool CheckMonotone>
+inline void RadixHeap<Key, CheckMonotone>::remove(int vertex)
+{
+	vector<int>& bucket = this->Buckets[this->Bucket[vertex]];
+
+	int moved = bucket.back();
+	int slot = this->Slot[vertex];
+
+	bucket[slot] = moved;
+	this->Slot[moved] = slot;
+	bucket.pop_back();
+
+	this->Bucket[vertex] = -1;
+	this->NumElements--;
+}
+
+
+//
+// a queued vertex with the smallest distance, the queue must not be
+// empty.  If bucket 0 is empty this finds the minimum of the first
+// non-empty bucket:
+//
+template <typename Key, bool CheckMonotone>
+int RadixHeap<Key, CheckMonotone>::minVertex()
+{
+	if (!this->Buckets[0].empty())
+		return this->Buckets[0].back();
+
+	int b = 1;
+	while (this->Buckets[b].empty())
+		b++;
+
+	int minV = this->Buckets[b][0];
+	for (int v : this->Buckets[b])
+	{
+		if (this->Keys[v] < this->Keys[minV])
+			minV = v;
+	}
+
+	return minV;
+}
+
+
+//
+// called when bucket 0 is empty: the smallest distance in the first
+// non-empty bucket becomes Last, and that bucket's vertices move to
+// lower buckets relative to it (at least one lands in bucket 0):
+//
+template <typename Key, bool CheckMonotone>
+void RadixHeap<Key, CheckMonotone>::redistribute()
+{
+	int b = 1;
+	while (this->Buckets[b].empty())
+		b++;
+
+	vector<int> vertices;
+	vertices.swap(this->Buckets[b]);
+
+	Key minKey = this->Keys[vertices[0]];
+	for (int v : vertices)
+	{
+		if (this->Keys[v] < minKey)
+			minKey = this->Keys[v];
+	}
+
+	this->Last = minKey;
+
+	for (int v : vertices)
+	{
+		int nb = this->bucketOf(this->Keys[v]);
+
+		this->Bucket[v] = nb;
+		this->Slot[v] = (int)this->Buckets[nb].size();
+		this->Buckets[nb].push_back(v);
+	}
+
+	// keep the bucket's capacity for the next time it fills up:
+	vertices.clear();
+	this->Buckets[b].swap(vertices);
+}
@@ -0,0 +1,137 @@
+/*shortestpathtree.h*/
+
+//
+//   Derives the predecessors of a shortest path tree from final
+// distances, in parallel, for the engines that compute distances with
+// concurrent atomic updates (DeltaStepping, ParallelDijkstra) and so
+// cannot record predecessors consistently while they run.
+//
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+
+#include "graph.h"
+#include "threadpool.h"
+
+using namespace std;
+
+
+//
+// FindPredecessors:
+//
+// Sets pred[t] of every reached vertex t (but the source) to a vertex u
+// with an edge u -> t on a shortest path, i.e. dist[u] + w == dist[t],
+// and -1 for the source and unreached vertices (dist == infinity).
+// Vertices reached over an edge with dist[u] < dist[t] take the
+// smallest such u.  Vertices only reached over zero-weight edges from
+// vertices at the same distance are then attached to vertices that
+// already have a path back to the source, one round at a time, so the
+// predecessors never form a cycle.  parent is scratch space for N
+// entries.
+//
+template <typename W>
+void FindPredecessors(const CSRGraph<W>& graph, int source, const W* dist, W infinity,
+                      atomic<int>* parent, int* pred, ThreadPool& pool)
+{
+	int N = graph.NumVertices();
+	int T = pool.Size();
+
+	auto forEachVertex = [&](int w, auto func)  // worker w's share of the vertices:
+	{
+		int64_t chunk = ((int64_t)N + T - 1) / T;
+		int     begin = (int)min<int64_t>((int64_t)w * chunk, N);
+		int     end = (int)min<int64_t>((int64_t)(w + 1) * chunk, N);
+
+		for (int u = begin; u < end; ++u)
+			func(u);
+	};
+
+	pool.Run([&](int w)
+	{
+		forEachVertex(w, [&](int v) { parent[v].store(N, memory_order_relaxed); });  // N => none yet:
+	});
+
+	atomic<int> orphans(0);
+
+	pool.Run([&](int w)
+	{
+		forEachVertex(w, [&](int u)
+		{
+			W du = dist[u];
+
+			if (du == infinity)
+				return;
+
+			for (int64_t e = graph.EdgesBegin(u); e < graph.EdgesEnd(u); ++e)
+			{
+				int t = graph.Target(e);
+				W   dt = dist[t];
+
+				if (du < dt && du + graph.Weight(e) == dt)
+				{
+					int current = parent[t].load(memory_order_relaxed);
+
+					while (u < current && !parent[t].compare_exchange_weak(current, u, memory_order_relaxed))
+						;
+				}
+			}
+		});
+	});
+
+	pool.Run([&](int w)
+	{
+		forEachVertex(w, [&](int v)
+		{
+			if (v != source && dist[v] != infinity && parent[v].load(memory_order_relaxed) == N)
+				orphans.fetch_add(1, memory_order_relaxed);
+		});
+	});
+
+	while (orphans.load() > 0)
+	{
+		atomic<int> attached(0);
+
+		pool.Run([&](int w)
+		{
+			forEachVertex(w, [&](int u)
+			{
+				if (u != source && parent[u].load(memory_order_relaxed) == N)
+					return;
+
+				W du = dist[u];
+
+				if (du == infinity)
+					return;
+
+				for (int64_t e = graph.EdgesBegin(u); e < graph.EdgesEnd(u); ++e)
+				{
+					int t = graph.Target(e);
+					int none = N;
+
+					if (t != source && graph.Weight(e) == W(0) && dist[t] == du
+						&& parent[t].compare_exchange_strong(none, u, memory_order_relaxed))
+						attached.fetch_add(1, memory_order_relaxed);
+				}
+			});
+		});
+
+		if (attached.load() == 0)  // cannot happen with exact distances:
+			break;
+
+		orphans.fetch_sub(attached.load());
+	}
+
+	pool.Run([&](int w)
+	{
+		forEachVertex(w, [&](int v)
+		{
+			int p = parent[v].load(memory_order_relaxed);
+			pred[v] = (p == N) ? -1 : p;
+		});
+	});
+}
@@ -0,0 +1,37 @@
+/*streamformat.h*/
+
+//
+//   StreamFormat saves the format flags and precision of a stream, and
+// restores them when it goes out of scope.  Output helpers that switch
+// cout to e.g. fixed with 2 decimals create one first, so the format
+// does not stick to the driver's later output.
+//
+
+#pragma once
+
+#include <iostream>
+
+using namespace std;
+
+
+class StreamFormat
+{
+private:
+  ostream&       Stream;
+  ios::fmtflags  Flags;
+  streamsize     Precision;
+
+public:
+  StreamFormat(ostream& stream)
+    : Stream(stream), Flags(stream.flags()), Precision(stream.precision())
+  { }
+
+  ~StreamFormat()
+  {
+    this->Stream.flags(this->Flags);
+    this->Stream.precision(this->Precision);
+  }
+
+  StreamFormat(const StreamFormat& other) = delete;
+  StreamFormat& operator=(const StreamFormat& other) = delete;
+};
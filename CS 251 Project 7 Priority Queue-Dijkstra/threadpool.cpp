@@ -0,0 +1,119 @@
+/*threadpool.cpp*/
+
+//
+//   The ThreadPool workers, see threadpool.h.
+//
+
+#include "threadpool.h"
+
+using namespace std;
+
+
+//
+// Constructor:
+//
+// Starts numThreads workers, or one per hardware thread if numThreads
+// is 0 (at least 1).
+//
+ThreadPool::ThreadPool(int numThreads)
+{
+	if (numThreads <= 0)
+		numThreads = (int)thread::hardware_concurrency();
+	if (numThreads <= 0)
+		numThreads = 1;
+
+	this->Generation = 0;
+	this->Running = 0;
+	this->Stopping = false;
+
+	for (int w = 0; w < numThreads; ++w)
+		this->Threads.emplace_back(&ThreadPool::work, this, w);
+}
+
+
+//
+// Destructor:
+//
+// Stops and joins the workers.
+//
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> guard(this->Lock);
+		this->Stopping = true;
+	}
+
+	this->Start.notify_all();
+
+	for (thread& t : this->Threads)
+		t.join();
+}
+
+
+//
+// Run:
+//
+// Calls task(w) on every worker w = 0..Size()-1, in parallel, and waits
+// for all of them to return.  If a task throws, the first exception is
+// rethrown here once all workers are done.  Run must not be called from
+// a task, or concurrently from several threads.
+//
+void ThreadPool::Run(const function<void(int)>& task)
+{
+	unique_lock<mutex> guard(this->Lock);
+
+	this->Task = task;
+	this->Running = (int)this->Threads.size();
+	this->Error = nullptr;
+	this->Generation++;
+
+	this->Start.notify_all();
+
+	this->Done.wait(guard, [this] { return this->Running == 0; });
+
+	this->Task = nullptr;
+
+	if (this->Error)
+		rethrow_exception(this->Error);
+}
+
+
+//
+// the loop of each worker: wait for the next task, run it, and report
+// back:
+//
+void ThreadPool::work(int worker)
+{
+	uint64_t seen = 0;
+
+	for (;;)
+	{
+		unique_lock<mutex> guard(this->Lock);
+
+		this->Start.wait(guard, [&] { return this->Stopping || this->Generation != seen; });
+
+		if (this->Stopping)
+			return;
+
+		seen = this->Generation;
+
+		guard.unlock();
+
+		try
+		{
+			this->Task(worker);
+		}
+		catch (...)
+		{
+			lock_guard<mutex> errorGuard(this->Lock);
+
+			if (!this->Error)
+				this->Error = current_exception();
+		}
+
+		guard.lock();
+
+		if (--this->Running == 0)
+			this->Done.notify_one();
+	}
+}
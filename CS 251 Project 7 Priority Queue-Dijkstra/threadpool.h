@@ -0,0 +1,50 @@
+/*threadpool.h*/
+
+//
+//   A fixed set of worker threads, started once and reused for every
+// batch of work, so a batch does not pay for thread creation.  Run()
+// hands the same task to every worker, passing the worker's number,
+// and returns when all of them have finished; the task itself divides
+// the work, e.g. by claiming items from a shared atomic counter.
+//
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstdint>
+
+using namespace std;
+
+
+class ThreadPool
+{
+private:
+  vector<thread>            Threads;
+  mutex                     Lock;
+  condition_variable        Start;       // a new task is available
+  condition_variable        Done;        // the last worker finished the task
+
+  function<void(int)>       Task;
+  uint64_t                  Generation;  // incremented for every task
+  int                       Running;     // # of workers still running the task
+  bool                      Stopping;
+  exception_ptr             Error;       // first exception thrown by the task
+
+  void work(int worker);
+
+public:
+  ThreadPool(int numThreads = 0);  // 0 => one per hardware thread:
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+
+  int  Size() const { return (int)this->Threads.size(); }
+
+  void Run(const function<void(int)>& task);
+};
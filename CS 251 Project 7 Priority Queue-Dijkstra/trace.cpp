@@ -0,0 +1,112 @@
+/*trace.cpp*/
+
+//
+//   Reading and recording binary queue traces, see trace.h.
+//
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#include "trace.h"
+
+using namespace std;
+
+
+//
+// TraceFile constructor:
+//
+// Maps the trace at path and checks its header.
+//
+TraceFile::TraceFile(const string& path)
+	: File(new MappedFile(path))
+{
+	TraceFileHeader header;
+
+	if (this->File->Size() < sizeof(header))
+		throw logic_error("TraceFile: '" + path + "' is not a trace file");
+
+	memcpy(&header, this->File->Data(), sizeof(header));
+
+	if (memcmp(header.Magic, "PQTRACE", 8) != 0)
+		throw logic_error("TraceFile: '" + path + "' is not a trace file");
+	if (header.Version != TRACE_FILE_VERSION)
+		throw logic_error("TraceFile: '" + path + "' has an unsupported version");
+	if (header.ByteOrder != FILE_BYTE_ORDER_MARK)
+		throw logic_error("TraceFile: '" + path + "' was written with a different byte order");
+	if (header.Count > (this->File->Size() - sizeof(header)) / sizeof(TraceOp))
+		throw logic_error("TraceFile: '" + path + "' is truncated");
+
+	this->Ops = (const TraceOp*)(this->File->Data() + sizeof(header));
+	this->Count = (size_t)header.Count;
+}
+
+
+//
+// RecordTrace:
+//
+size_t RecordTrace(istream& input, const string& path)
+{
+	vector<TraceOp> ops;
+	string          op;
+
+	input >> op;
+
+	while (op != "end")
+	{
+		if (!input)
+			throw logic_error("RecordTrace: missing \"end\"");
+
+		int vertex = 0, distance = 0;
+
+		if (op == "push")
+		{
+			input >> vertex;
+			input >> distance;
+
+			if (vertex < 0 || (uint32_t)vertex > TraceOp::MAX_VERTEX)
+				throw logic_error("RecordTrace: vertex out of range");
+
+			ops.push_back(TraceOp::Make(TRACE_PUSH, vertex, distance));
+		}
+		else if (op == "pop")
+			ops.push_back(TraceOp::Make(TRACE_POP));
+		else if (op == "top")
+			ops.push_back(TraceOp::Make(TRACE_TOP));
+		else if (op == "empty")
+			ops.push_back(TraceOp::Make(TRACE_EMPTY));
+		else if (op == "fill")
+		{
+			input >> distance;
+			ops.push_back(TraceOp::Make(TRACE_FILL, 0, distance));
+		}
+		else if (op == "reset")
+			ops.push_back(TraceOp::Make(TRACE_RESET));
+		else
+			throw logic_error("RecordTrace: unknown op '" + op + "'");
+
+		input >> op;
+	}
+
+	TraceFileHeader header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.Magic, "PQTRACE", 8);
+	header.Version = TRACE_FILE_VERSION;
+	header.ByteOrder = FILE_BYTE_ORDER_MARK;
+	header.Count = ops.size();
+
+	ofstream file(path, ios::binary | ios::trunc);
+
+	if (!file.good())
+		throw logic_error("RecordTrace: unable to create '" + path + "'");
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)ops.data(), (streamsize)(ops.size() * sizeof(TraceOp)));
+	file.close();
+
+	if (file.fail())
+		throw logic_error("RecordTrace: unable to write '" + path + "'");
+
+	return ops.size();
+}
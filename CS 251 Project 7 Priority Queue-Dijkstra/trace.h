@@ -0,0 +1,251 @@
+/*trace.h*/
+
+//
+//   Binary queue traces: a recorded sequence of queue operations in a
+// compact encoding, which can be replayed against any queue much faster
+// than the text commands of the driver.  The file is memory-mapped and
+// the operations are decoded in place, so a replay measures the queue
+// rather than parsing and iostreams.
+//
+//   Layout (in host byte order, see FILE_BYTE_ORDER_MARK in mappedfile.h):
+//
+//     TraceFileHeader   32 bytes
+//     TraceOp[Count]    8 bytes each
+//
+// Each op packs its code into the top 3 bits of Word and the vertex
+// into the low 29 bits, followed by the distance as a 32-bit integer
+// (the driver's distances are integers).
+//
+//   Version history:
+//     1 -- initial version.
+//
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+
+#include "mappedfile.h"
+
+using namespace std;
+
+
+enum TraceCode
+{
+  TRACE_PUSH  = 0,   // Push(vertex, distance)
+  TRACE_POP   = 1,   // PopMin()
+  TRACE_TOP   = 2,   // Top() and TopDistance()
+  TRACE_EMPTY = 3,   // Empty()
+  TRACE_FILL  = 4,   // Fill(distance)
+  TRACE_RESET = 5    // Reset()
+};
+
+
+struct TraceOp
+{
+  uint32_t  Word;      // code << 29 | vertex
+  int32_t   Distance;
+
+  static const uint32_t MAX_VERTEX = (1u << 29) - 1;
+
+  TraceCode Code() const   { return (TraceCode)(this->Word >> 29); }
+  int       Vertex() const { return (int)(this->Word & MAX_VERTEX); }
+
+  static TraceOp Make(TraceCode code, int vertex = 0, int32_t distance = 0)
+  {
+    TraceOp op;
+    op.Word = ((uint32_t)code << 29) | ((uint32_t)vertex & MAX_VERTEX);
+    op.Distance = distance;
+    return op;
+  }
+};
+
+static_assert(sizeof(TraceOp) == 8, "trace ops must be 8 bytes");
+
+
+struct TraceFileHeader
+{
+  char      Magic[8];    // "PQTRACE\0"
+  uint32_t  Version;     // TRACE_FILE_VERSION
+  uint32_t  ByteOrder;   // FILE_BYTE_ORDER_MARK
+  uint64_t  Count;       // # of ops
+  uint64_t  Reserved;
+};
+
+static_assert(sizeof(TraceFileHeader) == 32, "trace file header must be 32 bytes");
+
+const uint32_t TRACE_FILE_VERSION = 1;
+
+
+//
+// TraceFile:
+//
+// A trace file mapped into memory; the ops are valid as long as the
+// TraceFile exists.
+//
+class TraceFile
+{
+private:
+  unique_ptr<MappedFile>  File;
+  const TraceOp          *Ops;
+  size_t                  Count;
+
+public:
+  TraceFile(const string& path);  // throws a logic_error if not a valid trace:
+
+  const TraceOp* Data() const { return this->Ops; }
+  size_t         Size() const { return this->Count; }
+};
+
+
+//
+// RecordTrace:
+//
+// Reads text ops from input up to "end" -- "push v d", "pop", "top",
+// "empty", "fill d" and "reset", as in the driver -- and writes them to
+// path as a binary trace.  Returns the # of ops written; throws a
+// logic_error on an unknown op, a vertex out of range, or a write error.
+//
+size_t RecordTrace(istream& input, const string& path);
+
+
+//
+// the outcome of a replay:
+//
+struct TraceResult
+{
+  size_t    Ops;
+  size_t    Pops;       // successful pops
+  size_t    Errors;     // ops that threw (e.g. pop on an empty queue)
+  uint64_t  Checksum;   // of the popped vertices, in order
+  double    Seconds;
+};
+
+
+//
+// formats a distance like cout does by default (6 significant digits):
+//
+template <typename Key>
+string TraceDistance(Key distance)
+{
+	char text[32];
+
+	snprintf(text, sizeof(text), "%g", (double)distance);
+
+	return text;
+}
+
+
+//
+// ReplayTrace:
+//
+// Replays n ops against pq.  If out is not null, every op prints a line
+// like the driver's text commands do, collected in a buffer and written
+// in large blocks, never flushed per line; otherwise nothing is printed
+// and only the result is computed.  The vertices must be valid for pq;
+// in an unchecked build (PQUEUE_UNCHECKED) pops and tops of an empty
+// queue are still caught, as in the driver.
+//
+template <typename Queue>
+TraceResult ReplayTrace(Queue& pq, const TraceOp* ops, size_t n, ostream* out)
+{
+	const size_t FLUSH_AT = 1 << 16;
+
+	TraceResult result = { n, 0, 0, 0, 0.0 };
+	string      buffer;
+
+	auto start = chrono::steady_clock::now();
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const TraceOp& op = ops[i];
+
+		try
+		{
+			switch (op.Code())
+			{
+			case TRACE_PUSH:
+				pq.Push(op.Vertex(), op.Distance);
+				if (out)
+					buffer += "Push: (" + to_string(op.Vertex()) + "," + to_string(op.Distance) + ")\n";
+				break;
+
+			case TRACE_POP:
+			{
+#ifdef PQUEUE_UNCHECKED
+				if (pq.Empty())
+					throw logic_error("stack empty!");
+#endif
+
+				int v = pq.PopMin();
+				result.Pops++;
+				result.Checksum = result.Checksum * 31 + (uint64_t)v;
+				if (out)
+					buffer += "PopMin: vertex " + to_string(v) + "\n";
+				break;
+			}
+
+			case TRACE_TOP:
+			{
+#ifdef PQUEUE_UNCHECKED
+				if (pq.Empty())
+					throw logic_error("stack empty!");
+#endif
+
+				int v = pq.Top();
+				if (out)
+					buffer += "Top: (" + to_string(v) + "," + TraceDistance(pq.TopDistance()) + ")\n";
+				break;
+			}
+
+			case TRACE_EMPTY:
+			{
+				bool empty = pq.Empty();
+				if (out)
+					buffer += string("Empty: ") + (empty ? "1" : "0") + "\n";
+				break;
+			}
+
+			case TRACE_FILL:
+				pq.Fill(op.Distance);
+				break;
+
+			case TRACE_RESET:
+				pq.Reset();
+				break;
+
+			default:
+				throw logic_error("invalid trace op");
+			}
+		}
+		catch (logic_error& le)
+		{
+			static const char* names[] = { "Push: ", "PopMin: ", "Top: ", "Empty: ", "Fill: ", "Reset: ", "?: ", "?: " };
+
+			result.Errors++;
+			if (out)
+				buffer += string(names[op.Code()]) + le.what() + "\n";
+		}
+
+		if (out && buffer.size() >= FLUSH_AT)
+		{
+			out->write(buffer.data(), (streamsize)buffer.size());
+			buffer.clear();
+		}
+	}
+
+	auto stop = chrono::steady_clock::now();
+
+	if (out)
+		out->write(buffer.data(), (streamsize)buffer.size());
+
+	result.Seconds = chrono::duration<double>(stop - start).count();
+
+	return result;
+}
@@ -0,0 +1,138 @@
+/*vertexorder.cpp*/
+
+//
+//   VertexOrder and the Hilbert curve order, see vertexorder.h.
+//
+
+#include <cstdint>
+#include <utility>
+
+#include "vertexorder.h"
+
+using namespace std;
+
+
+//
+// Constructor:
+//
+// The order in which new vertex i is original vertex oldIds[i], which
+// must be a permutation of 0..N-1; throws a logic_error if it is not.
+//
+VertexOrder::VertexOrder(vector<int> oldIds)
+	: NewIds(oldIds.size(), -1), OldIds(std::move(oldIds))
+{
+	int N = this->Size();
+
+	for (int i = 0; i < N; ++i)
+	{
+		int v = this->OldIds[i];
+
+		if (v < 0 || v >= N || this->NewIds[v] != -1)
+			throw logic_error("VertexOrder: not a permutation of 0..N-1");
+
+		this->NewIds[v] = i;
+	}
+}
+
+
+//
+// Then:
+//
+// The order that renumbers by this order and then renumbers the result
+// by next, e.g. to reorder a graph that was already reordered before.
+// next must have the same # of vertices (or either may be the identity).
+//
+VertexOrder VertexOrder::Then(const VertexOrder& next) const
+{
+	if (this->Identity())
+		return next;
+	if (next.Identity())
+		return *this;
+
+	if (next.Size() != this->Size())
+		throw logic_error("VertexOrder::Then: orders have different # of vertices");
+
+	vector<int> oldIds(this->Size());
+
+	for (int i = 0; i < this->Size(); ++i)
+		oldIds[i] = this->OldIds[next.OldIds[i]];
+
+	return VertexOrder(std::move(oldIds));
+}
+
+
+/*************************** PRIVATE HELPER FUNCTIONS *******************************/
+
+//
+// distance along the Hilbert curve through a 2^16 x 2^16 grid of the
+// cell (x, y):
+//
+static uint64_t hilbertIndex(uint32_t x, uint32_t y)
+{
+	uint64_t d = 0;
+
+	for (uint32_t s = 1u << 15; s > 0; s >>= 1)
+	{
+		uint32_t rx = (x & s) ? 1 : 0;
+		uint32_t ry = (y & s) ? 1 : 0;
+
+		d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+		if (ry == 0)  // rotate the quadrant, so the curve stays connected:
+		{
+			if (rx == 1)  // the bits above s are done, flipping them is harmless:
+			{
+				x = 0xFFFF - x;
+				y = 0xFFFF - y;
+			}
+
+			swap(x, y);
+		}
+	}
+
+	return d;
+}
+
+
+//
+// HilbertOrder:
+//
+// Vertex v at (X[v], Y[v]); the vertices are sorted by their position
+// along a Hilbert curve through the bounding box of the coordinates, so
+// vertices close together in the plane get close ids.  Throws a
+// logic_error if X and Y differ in size.
+//
+VertexOrder HilbertOrder(const vector<double>& X, const vector<double>& Y)
+{
+	if (X.size() != Y.size())
+		throw logic_error("HilbertOrder: need one X and one Y per vertex");
+
+	int N = (int)X.size();
+
+	if (N == 0)
+		return VertexOrder();
+
+	double minX = *min_element(X.begin(), X.end()), maxX = *max_element(X.begin(), X.end());
+	double minY = *min_element(Y.begin(), Y.end()), maxY = *max_element(Y.begin(), Y.end());
+	double span = max(maxX - minX, maxY - minY);
+	double scale = (span > 0.0) ? 65535.0 / span : 0.0;
+
+	vector<pair<uint64_t, int>> keyed(N);
+
+	for (int v = 0; v < N; ++v)
+	{
+		uint32_t x = (uint32_t)((X[v] - minX) * scale);
+		uint32_t y = (uint32_t)((Y[v] - minY) * scale);
+
+		keyed[v] = { hilbertIndex(x, y), v };
+	}
+
+	sort(keyed.begin(), keyed.end());
+
+	vector<int> oldIds(N);
+
+	for (int i = 0; i < N; ++i)
+		oldIds[i] = keyed[i].second;
+
+	return VertexOrder(std::move(oldIds));
+}
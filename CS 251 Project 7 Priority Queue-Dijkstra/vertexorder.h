@@ -0,0 +1,147 @@
+/*vertexorder.h*/
+
+//
+//   Vertex renumbering for locality.  Vertex ids usually come from the
+// input order, so the neighbours of a vertex have unrelated ids, and
+// every relaxation touches the distance array, the queue's positions
+// and the adjacency at random.  Renumbering the graph so that
+// neighbours get nearby ids turns most of those accesses into nearby
+// ones:
+//
+//   CuthillMcKeeOrder -- reverse Cuthill-McKee: a breadth-first order,
+//                        visiting neighbours by ascending degree, then
+//                        reversed; needs only the graph.
+//   HilbertOrder      -- vertices sorted along a Hilbert curve through
+//                        their coordinates, for geometric (road) graphs.
+//
+//   A VertexOrder keeps both directions of the permutation, so the
+// graph is searched in the new ids (see CSRGraph::Permuted) while the
+// vertices are input and reported in the original ids.
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+
+#include "graph.h"
+
+using namespace std;
+
+
+class VertexOrder
+{
+private:
+  vector<int>  NewIds;  // new id of every original vertex
+  vector<int>  OldIds;  // original id of every new vertex
+
+public:
+  VertexOrder() { }  // the identity: ids are not changed
+  explicit VertexOrder(vector<int> oldIds);
+
+  bool Identity() const  { return this->OldIds.empty(); }
+  int  Size() const      { return (int)this->OldIds.size(); }
+
+  //
+  // ids outside 0..N-1 are passed through unchanged, so the engine
+  // reports them as invalid:
+  //
+  int  ToNew(int v) const       { return (v >= 0 && v < this->Size()) ? this->NewIds[v] : v; }
+  int  ToOriginal(int v) const  { return (v >= 0 && v < this->Size()) ? this->OldIds[v] : v; }
+
+  const vector<int>& NewIdArray() const  { return this->NewIds; }
+  const vector<int>& OldIdArray() const  { return this->OldIds; }
+
+  VertexOrder Then(const VertexOrder& next) const;
+};
+
+
+VertexOrder HilbertOrder(const vector<double>& X, const vector<double>& Y);
+
+
+//
+// CuthillMcKeeOrder:
+//
+// The reverse Cuthill-McKee order of the graph: breadth-first from a
+// vertex of lowest out-degree, queueing the unvisited neighbours of
+// each vertex by ascending out-degree, restarting from the next
+// lowest-degree unvisited vertex until every vertex is ordered, and
+// finally reversed.  O(N log N + M).
+//
+template <typename W>
+VertexOrder CuthillMcKeeOrder(const CSRGraph<W>& graph)
+{
+	int N = graph.NumVertices();
+
+	auto degree = [&](int v) { return graph.EdgesEnd(v) - graph.EdgesBegin(v); };
+	auto byDegree = [&](int a, int b) { return degree(a) < degree(b) || (degree(a) == degree(b) && a < b); };
+
+	vector<int> starts(N);
+	iota(starts.begin(), starts.end(), 0);
+	sort(starts.begin(), starts.end(), byDegree);
+
+	vector<int>  order;
+	vector<char> visited(N, 0);
+
+	order.reserve(N);
+
+	for (int s : starts)
+	{
+		if (visited[s])
+			continue;
+
+		visited[s] = 1;
+		order.push_back(s);
+
+		//
+		// order itself is the BFS queue, from this start on:
+		//
+		for (size_t head = order.size() - 1; head < order.size(); ++head)
+		{
+			int    u = order[head];
+			size_t first = order.size();
+
+			for (int64_t e = graph.EdgesBegin(u); e < graph.EdgesEnd(u); ++e)
+			{
+				int t = graph.Target(e);
+
+				if (!visited[t])
+				{
+					visited[t] = 1;
+					order.push_back(t);
+				}
+			}
+
+			sort(order.begin() + first, order.end(), byDegree);
+		}
+	}
+
+	reverse(order.begin(), order.end());
+
+	return VertexOrder(std::move(order));
+}
+
+
+//
+// MeanEdgeSpan:
+//
+// The average |u - t| over the edges u -> t of the graph, a measure of
+// how far apart in memory relaxing a vertex reaches (0 if no edges).
+//
+template <typename W>
+double MeanEdgeSpan(const CSRGraph<W>& graph)
+{
+	double total = 0.0;
+
+	for (int u = 0; u < graph.NumVertices(); ++u)
+	{
+		for (int64_t e = graph.EdgesBegin(u); e < graph.EdgesEnd(u); ++e)
+			total += (double)abs(graph.Target(e) - u);
+	}
+
+	return (graph.NumEdges() > 0) ? total / (double)graph.NumEdges() : 0.0;
+}